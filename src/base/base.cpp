@@ -1,6 +1,5 @@
 #include "base.hpp"
 
-#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
 
 #define _USE_MATH_DEFINES
@@ -78,27 +77,92 @@ void Renderer::initCamera() {
 }
 
 void Renderer::clear() {
-  glfwDestroyWindow(g_window);
-  glfwTerminate();
+  if(cameraUbo) {
+    glDeleteBuffers(1, &cameraUbo);
+    cameraUbo = 0;
+  }
+  if(lightsUbo) {
+    glDeleteBuffers(1, &lightsUbo);
+    lightsUbo = 0;
+  }
+  // Deleted while the context exists, they free their GPU buffers
   for (unsigned i = 0; i < renderables.size(); i++){
     if(renderables[i]) {
       delete renderables[i];
     }
   }
+  renderables.clear();
   for (unsigned i = 0; i < lights.size(); i++){
     if(lights[i]) {
       delete lights[i];
     }
   }
+  lights.clear();
+  glfwDestroyWindow(g_window);
+  glfwTerminate();
+}
+
+/*Camera matrices and position, sent once per frame.*/
+void Renderer::updateCameraUniforms() {
+  CameraUniformBlock block;
+  block.viewMat = g_camera.computeViewMatrix();
+  block.projMat = g_camera.computeProjectionMatrix();
+  block.cameraPos = g_camera.getPosition();
+  block.padding = 0.0f;
+
+  if(!cameraUbo) {
+    glGenBuffers(1, &cameraUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, cameraUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraUniformBlock), nullptr, GL_DYNAMIC_DRAW);
+  }
+  glBindBuffer(GL_UNIFORM_BUFFER, cameraUbo);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraUniformBlock), &block);
+  glBindBufferBase(GL_UNIFORM_BUFFER, UNIFORM_BLOCK_BINDING_CAMERA, cameraUbo);
+  getOpenGLError("camera uniform block");
+}
+
+/*
+Lights data and shadow maps, sent once per frame after the shadow maps
+rendering. The program must be in use.
+*/
+void Renderer::updateLightsUniforms(Program & program) {
+  Light::UniformBlock block;
+  memset(&block, 0, sizeof(block));
+  const unsigned count = glm::min(unsigned(lights.size()), unsigned(MAX_LIGHTS));
+  GLint shadowMapUnits[MAX_LIGHTS];
+  for(unsigned i=0; i<count; i++) {
+    lights[i]->getUniformData(block.lights[i]);
+    lights[i]->bindShadowMap(i);
+    shadowMapUnits[i] = MAP_TEXTURE_UNIT_DEPTH_MAP+i;
+  }
+  block.lightCount = count;
+
+  if(!lightsUbo) {
+    glGenBuffers(1, &lightsUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, lightsUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Light::UniformBlock), nullptr, GL_DYNAMIC_DRAW);
+  }
+  glBindBuffer(GL_UNIFORM_BUFFER, lightsUbo);
+  glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Light::UniformBlock), &block);
+  glBindBufferBase(GL_UNIFORM_BUFFER, UNIFORM_BLOCK_BINDING_LIGHTS, lightsUbo);
+  getOpenGLError("lights uniform block");
+
+  if(count > 0) {
+    glUniform1iv(program.getUniformLocation(Program::UniformShadowMaps), count, shadowMapUnits);
+    getOpenGLError("uniform shadow maps");
+  }
 }
 
 // static int photo = 0;
 // static int photoId = 0;
 
 void Renderer::render() {
-  GLuint singleColorProgram = Program::getInstanceSingleColor()->getProgram();
-  GLuint shadowProgram = Program::getInstanceShadowMap()->getProgram();
-  GLuint phongProgram = Program::getInstancePhong()->getProgram();
+  Program & singleColor = *Program::getInstanceSingleColor();
+  Program & shadowMap = *Program::getInstanceShadowMap();
+  Program & phong = *Program::getInstancePhong();
+  GLuint singleColorProgram = singleColor.getProgram();
+  GLuint shadowProgram = shadowMap.getProgram();
+  GLuint phongProgram = phong.getProgram();
 
   glViewport(0, 0, width, height);
   glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
@@ -106,11 +170,9 @@ void Renderer::render() {
 
   // Some inits for lights
   for (unsigned i = 0; i < lights.size(); i++){
-    if(!lights[i]->uniformNamePos) {
-      lights[i]->init(width, height);
-      lights[i]->buildUniformNames(i);
-    }
+    lights[i]->init(width, height);
   }
+  updateCameraUniforms();
 
   // Some inits for renderables
   for (unsigned i = 0; i < renderables.size(); i++) {
@@ -132,7 +194,7 @@ void Renderer::render() {
 
       for (unsigned j = 0; j < renderables.size(); j++) {
         auto m = renderables[j];
-        m->render(*this, shadowProgram);
+        m->render(*this, shadowMap);
       }
 
       // if(photo == 200) {
@@ -156,14 +218,20 @@ void Renderer::render() {
     glDisable(GL_CULL_FACE);
   }
   glUseProgram(phongProgram);
+  updateLightsUniforms(phong);
+  for (unsigned i = 0; i < renderables.size(); i++) {
+      auto m = renderables[i];
+      if(!m->depthTest()) continue;
+      if(!m->isHighlightable || !m->isHighlighted) m->render(*this, phong);
+  }
+  // Objects without depth test are drawn over the other ones
+  glDisable(GL_DEPTH_TEST);
   for (unsigned i = 0; i < renderables.size(); i++) {
-      if(!renderables[i]->depthTest()) {
-        glDisable(GL_DEPTH_TEST);
-      }
       auto m = renderables[i];
-      if(!m->isHighlightable || !m->isHighlighted) m->render(*this, phongProgram);
-      glEnable(GL_DEPTH_TEST);
+      if(m->depthTest()) continue;
+      if(!m->isHighlightable || !m->isHighlighted) m->render(*this, phong);
   }
+  glEnable(GL_DEPTH_TEST);
   
   // Fill stencil buffer with ones for highlighted objects
   glEnable(GL_DEPTH_TEST);
@@ -173,7 +241,7 @@ void Renderer::render() {
   glUseProgram(phongProgram);
   for (unsigned i = 0; i < renderables.size(); i++) {
       auto m = renderables[i];
-      if(m->isHighlightable && m->isHighlighted) m->render(*this, phongProgram);
+      if(m->isHighlightable && m->isHighlighted) m->render(*this, phong);
   }
 
   // Hightlight objects to highlight
@@ -181,11 +249,11 @@ void Renderer::render() {
   glDisable(GL_DEPTH_TEST);
   glUseProgram(singleColorProgram);
   glm::vec4 heighLightColor = {0.1f, 0.1f, 0.8f, 1.0f};
-  glUniform4f(glGetUniformLocation(singleColorProgram, "singleColor"),
+  glUniform4f(singleColor.getUniformLocation(Program::UniformSingleColor),
     heighLightColor.r, heighLightColor.g, heighLightColor.b, heighLightColor.a);
   for (unsigned i = 0; i < renderables.size(); i++) {
       auto m = renderables[i];
-      if(m->isHighlightable && m->isHighlighted) m->render(*this, singleColorProgram, glm::scale(glm::vec3(1.1f, 1.1f, 1.1f)));
+      if(m->isHighlightable && m->isHighlighted) m->render(*this, singleColor, glm::scale(glm::vec3(1.1f, 1.1f, 1.1f)));
   }
 }
 
@@ -7,6 +7,8 @@
 #include <frame-buffer.hpp>
 #include <geometry/geometry.hpp>
 
+#define UNIFORM_BLOCK_BINDING_CAMERA 1
+
 typedef void (*WindowSizeCallback)(GLFWwindow* window, int width, int height);
 typedef void (*KeyCallback)(GLFWwindow* window, int key, int scancode, int action, int mods);
 typedef void (*ErrorCallback)(int error, const char *desc);
@@ -23,11 +25,13 @@ Hold any renderable model.
 class Renderable {
   friend class Renderer;
 public:
+  virtual ~Renderable() = default;
+
   /*Init GPU buffers.*/
   virtual void init() = 0;
 
   /*Render the model.*/
-  virtual void render(Renderer & renderer, GLuint program=0,
+  virtual void render(Renderer & renderer, Program & program,
     const glm::mat4 & extraTransformFirst = glm::mat4(1),
     const glm::mat4 & extraTransformLast = glm::mat4(1)) = 0;
 
@@ -77,6 +81,21 @@ protected:
 
   bool withFaceCull = true;
 
+  /*The Camera uniform block (std140 layout).*/
+  struct CameraUniformBlock {
+    glm::mat4 viewMat;
+    glm::mat4 projMat;
+    glm::vec3 cameraPos;
+    float padding;
+  };
+
+  // Uniform blocks shared by every draw of a frame
+  GLuint cameraUbo = 0;
+  GLuint lightsUbo = 0;
+
+  void updateCameraUniforms();
+  void updateLightsUniforms(Program & program);
+
 public:
 
   inline void faceCulling(bool v) { withFaceCull = v; }
@@ -0,0 +1,174 @@
+#include "bone-gizmos.hpp"
+
+#include <cstddef>
+
+// Pyramid from the bone point A to its point B, in the bone frame :
+// x goes from A to B, y and z are the (scaled) half widths at B
+static const glm::vec3 gizmoVertices[] = {
+    {0, 0, 0}, {1, 0, 1}, {1, 0, -1},
+    {0, 0, 0}, {1, 1, 0}, {1, 0, 1},
+    {0, 0, 0}, {1, 1, 0}, {1, 0, -1}
+};
+static const unsigned gizmoVerticesCount = 9;
+static const float gizmoWidth = 0.02f;
+
+BoneGizmos::BoneGizmos() {
+    setHighLightable(false);
+    Program::getInstanceBoneGizmo()->subscribe();
+}
+
+BoneGizmos::~BoneGizmos() {
+    if(m_vao) {
+        glDeleteVertexArrays(1, &m_vao);
+        m_vao = 0;
+    }
+    if(m_posVbo) {
+        glDeleteBuffers(1, &m_posVbo);
+        m_posVbo = 0;
+    }
+    if(m_instanceVbo) {
+        glDeleteBuffers(1, &m_instanceVbo);
+        m_instanceVbo = 0;
+    }
+    Program::getInstanceBoneGizmo()->unsubscribe();
+}
+
+BoneGizmos::SkeletonGizmos * BoneGizmos::findSkeleton(MeshSkeleton * skeleton) {
+    for(auto & s : skeletons) {
+        if(s.skeleton == skeleton) return &s;
+    }
+    return nullptr;
+}
+
+void BoneGizmos::addSkeleton(MeshSkeleton * skeleton, const glm::vec3 & color) {
+    if(findSkeleton(skeleton)) return;
+    SkeletonGizmos s;
+    s.skeleton = skeleton;
+    s.color = color;
+    s.highlightColor = color;
+    s.highlightedBone = -1;
+    s.visible = true;
+    s.bonesVersion = skeleton->getBonesVersion();
+    skeletons.push_back(s);
+    instancesChanged = true;
+}
+
+void BoneGizmos::removeSkeleton(MeshSkeleton * skeleton) {
+    for(auto it=skeletons.begin(); it!=skeletons.end(); it++) {
+        if(it->skeleton == skeleton) {
+            skeletons.erase(it);
+            instancesChanged = true;
+            return;
+        }
+    }
+}
+
+void BoneGizmos::setVisible(MeshSkeleton * skeleton, bool visible) {
+    auto s = findSkeleton(skeleton);
+    if(s && s->visible != visible) {
+        s->visible = visible;
+        instancesChanged = true;
+    }
+}
+
+void BoneGizmos::setHighlightedBone(MeshSkeleton * skeleton, int boneIndex, const glm::vec3 & highlightColor) {
+    auto s = findSkeleton(skeleton);
+    if(s) {
+        s->highlightedBone = boneIndex;
+        s->highlightColor = highlightColor;
+        instancesChanged = true;
+    }
+}
+
+/*
+Rebuild the instances if a skeleton changed or one of its bones moved,
+the buffer grows by doubling its capacity.
+*/
+void BoneGizmos::updateInstances() {
+    for(auto & s : skeletons) {
+        if(s.bonesVersion != s.skeleton->getBonesVersion()) {
+            s.bonesVersion = s.skeleton->getBonesVersion();
+            instancesChanged = true;
+        }
+    }
+    if(!instancesChanged) return;
+
+    instances.clear();
+    for(auto & s : skeletons) {
+        if(!s.visible) continue;
+        const auto & bones = s.skeleton->getBones();
+        const auto & matrices = s.skeleton->getBonesMatrices();
+        for(unsigned b=0; b<bones.size(); b++) {
+            const auto & bone = bones[b];
+            glm::vec3 v = glm::normalize(glm::cross(bone.A-bone.B, glm::vec3(0, 0, 1)));
+            glm::mat4 frame(
+                glm::vec4(bone.B-bone.A, 0),
+                glm::vec4(v*gizmoWidth, 0),
+                glm::vec4(0, 0, gizmoWidth, 0),
+                glm::vec4(bone.A, 1)
+            );
+            Instance instance;
+            instance.transform = matrices[b] * frame;
+            instance.color = glm::vec4(int(b)==s.highlightedBone ? s.highlightColor : s.color, 1);
+            instances.push_back(instance);
+        }
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    if(instances.size() > instanceCapacity) {
+        instanceCapacity = glm::max(unsigned(instances.size()), 2*instanceCapacity);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(Instance)*instanceCapacity, nullptr, GL_DYNAMIC_DRAW);
+    }
+    if(instances.size() > 0) {
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Instance)*instances.size(), instances.data());
+    }
+    getOpenGLError("bone gizmos instances");
+    instancesChanged = false;
+}
+
+void BoneGizmos::init() {
+    glGenVertexArrays(1, &m_vao);
+    glBindVertexArray(m_vao);
+
+    glGenBuffers(1, &m_posVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(gizmoVertices), gizmoVertices, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), 0);
+    glEnableVertexAttribArray(0);
+
+    // The transform takes the locations 1 to 4, one per column
+    glGenBuffers(1, &m_instanceVbo);
+    glBindBuffer(GL_ARRAY_BUFFER, m_instanceVbo);
+    for(unsigned c=0; c<4; c++) {
+        glVertexAttribPointer(1+c, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+            (void*)(offsetof(Instance, transform) + c*sizeof(glm::vec4)));
+        glVertexAttribDivisor(1+c, 1);
+        glEnableVertexAttribArray(1+c);
+    }
+    glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void*)offsetof(Instance, color));
+    glVertexAttribDivisor(5, 1);
+    glEnableVertexAttribArray(5);
+
+    glBindVertexArray(0);
+    getOpenGLError("bone gizmos buffers");
+
+    instanceCapacity = 0;
+    instancesChanged = true;
+    isInitialized = true;
+}
+
+void BoneGizmos::render(Renderer & renderer, Program & program,
+    const glm::mat4 & extraTransformFirst,
+    const glm::mat4 & extraTransformLast)
+{
+    if(&program != Program::getInstancePhong()) return;
+
+    updateInstances();
+    if(instances.empty()) return;
+
+    glUseProgram(Program::getInstanceBoneGizmo()->getProgram());
+    glBindVertexArray(m_vao);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, gizmoVerticesCount, instances.size());
+    getOpenGLError("bone gizmos draw");
+    glUseProgram(program.getProgram());
+}
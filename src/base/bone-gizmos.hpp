@@ -0,0 +1,72 @@
+#ifndef _SKETCHY_BONE_GIZMOS_
+#define _SKETCHY_BONE_GIZMOS_
+
+#include <utils.hpp>
+#include <base.hpp>
+#include <mesh-skeleton.hpp>
+
+/*
+Draws the bones of all the skeletons added to it with one instanced draw :
+every bone is an instance of the same pyramid, placed by its transform
+in a per-instance buffer. The buffer is only uploaded again when a bone
+moves or a skeleton changes.
+Drawn with its own program, during the Phong pass only.
+*/
+class BoneGizmos: public Renderable {
+public:
+    BoneGizmos();
+    ~BoneGizmos();
+
+    void addSkeleton(MeshSkeleton * skeleton, const glm::vec3 & color);
+    /*To call before the skeleton is deleted. Does nothing if it is not added.*/
+    void removeSkeleton(MeshSkeleton * skeleton);
+    void setVisible(MeshSkeleton * skeleton, bool visible);
+    /*The bone of the skeleton drawn with highlightColor, -1 for none.*/
+    void setHighlightedBone(MeshSkeleton * skeleton, int boneIndex, const glm::vec3 & highlightColor);
+
+    void init() override;
+    void render(Renderer & renderer, Program & program,
+        const glm::mat4 & extraTransformFirst,
+        const glm::mat4 & extraTransformLast) override;
+
+    inline bool isMeshhInitialized() override { return isInitialized; }
+
+    inline const Geometry::BoundingBox::BoundingBox & getBoundingBox() override {
+        return boundingBox;
+    }
+
+    inline glm::mat4 getWorldTransform() override { return glm::mat4(1); }
+
+private:
+    struct SkeletonGizmos {
+        MeshSkeleton * skeleton;
+        glm::vec3 color;
+        glm::vec3 highlightColor;
+        int highlightedBone;
+        bool visible;
+        // Bones version of the skeleton in the instance buffer
+        unsigned bonesVersion;
+    };
+
+    struct Instance {
+        glm::mat4 transform;
+        glm::vec4 color;
+    };
+
+    std::vector<SkeletonGizmos> skeletons;
+    std::vector<Instance> instances;
+    bool instancesChanged = true;
+
+    bool isInitialized = false;
+    GLuint m_vao = 0;
+    GLuint m_posVbo = 0;
+    GLuint m_instanceVbo = 0;
+    unsigned instanceCapacity = 0;
+
+    Geometry::BoundingBox::BoundingBox boundingBox;
+
+    SkeletonGizmos * findSkeleton(MeshSkeleton * skeleton);
+    void updateInstances();
+};
+
+#endif
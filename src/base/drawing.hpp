@@ -43,12 +43,7 @@ public:
 
       // std::cout << "xPos = " << xPos << " yPos = " << yPos << std::endl;
 
-      getOpenGLError("Drawing before update");
-      size_t length = sizeof(float)*drawing.size()*3;
-      glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
-      glBufferData(GL_ARRAY_BUFFER, length, drawing.data(), GL_DYNAMIC_READ);
-      glBindBuffer(GL_ARRAY_BUFFER, 0);
-      getOpenGLError("Drawing update");
+      uploadPoints(drawing.size()-1);
     }
   }
 
@@ -138,12 +133,7 @@ public:
   inline void clearDrawing() {
     drawing.clear();
     subDrawingStarts.clear();
-    getOpenGLError("Drawing before update");
-    size_t length = sizeof(float)*drawing.size()*3;
-    glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
-    glBufferData(GL_ARRAY_BUFFER, length, drawing.data(), GL_DYNAMIC_READ);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    getOpenGLError("Drawing update");
+    // The buffer keeps its capacity for the next drawing
   }
 
   inline void loadShape(const char * filename) {
@@ -240,6 +230,8 @@ private:
 
   GLuint m_vao = 0;
   GLuint m_posVbo = 0;
+  // Number of points the pos buffer object can hold
+  size_t posCapacity = 0;
 
   ImageTexture * coverTexture = nullptr;
   GLuint tex_vao = 0;
@@ -259,6 +251,7 @@ private:
     glGenBuffers(1, &m_posVbo);
     glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
     glBufferData(GL_ARRAY_BUFFER, length, drawing.data(), GL_DYNAMIC_DRAW);
+    posCapacity = drawing.size();
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, 0);
     glEnableVertexAttribArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
@@ -266,6 +259,30 @@ private:
     getOpenGLError("Drawing init");
   }
 
+  /*
+  Send the points from first to the end of the drawing.
+  The pos buffer object grows by doubling its capacity, so each new point
+  only costs its own upload instead of the whole drawing.
+  */
+  void uploadPoints(size_t first) {
+    getOpenGLError("Drawing before update");
+    glBindBuffer(GL_ARRAY_BUFFER, m_posVbo);
+    if(drawing.size() > posCapacity) {
+      posCapacity = std::max(drawing.size(), std::max(2*posCapacity, size_t(1024)));
+      glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3)*posCapacity, nullptr, GL_DYNAMIC_DRAW);
+      first = 0;
+    }
+    if(first < drawing.size()) {
+      glBufferSubData(
+        GL_ARRAY_BUFFER,
+        sizeof(glm::vec3)*first,
+        sizeof(glm::vec3)*(drawing.size()-first),
+        drawing.data()+first);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    getOpenGLError("Drawing update");
+  }
+
   void renderPositionsSet(
     const std::vector<unsigned> & positionsStarts,
     const std::vector<glm::vec3> & positions,
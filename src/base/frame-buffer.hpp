@@ -3,10 +3,6 @@
 
 #include <utils.hpp>
 
-#ifndef STB_IMAGE_WRITE_IMPLEMENTATION
-#define STB_IMAGE_WRITE_IMPLEMENTATION
-#endif
-
 class FrameBuffer {
 protected:
     GLuint fbo;
@@ -1,9 +1,7 @@
 #include "draw-2d.hpp"
 
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
-#endif
 
 namespace Geometry {
 
@@ -183,7 +181,11 @@ void DrawBuilder::savePPM(std::string const & filename) {
     output_image.close();
 }
 
-void DrawBuilder::savePNG(std::string const & filename) {
+void writePNG(
+    std::string const & filename,
+    unsigned width, unsigned height,
+    const uint8_t * pixels
+) {
     stbi_write_png(
         filename.c_str(),
         width, height,
@@ -192,4 +194,8 @@ void DrawBuilder::savePNG(std::string const & filename) {
     );
 }
 
+void DrawBuilder::savePNG(std::string const & filename) {
+    writePNG(filename, width, height, pixels);
+}
+
 }
\ No newline at end of file
@@ -56,6 +56,13 @@ inline void insertLine(
     }
 }
 
+/*Write RGB pixels (3 bytes per pixel, row by row) in a PNG file.*/
+void writePNG(
+    std::string const & filename,
+    unsigned width, unsigned height,
+    const uint8_t * pixels
+);
+
 class DrawBuilder {
 public:
     DrawBuilder(
@@ -110,6 +117,10 @@ public:
         extraPoints.clear();
     }
 
+    inline const uint8_t * getPixels() const { return pixels; }
+    inline unsigned getWidth() const { return width; }
+    inline unsigned getHeight() const { return height; }
+
     void savePPM(std::string const & filename);
     void savePNG(std::string const & filename);
 
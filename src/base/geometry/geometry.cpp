@@ -1,5 +1,7 @@
 #include "geometry.hpp"
 
+#include <functional>
+
 namespace Geometry {
 
 /*
@@ -237,6 +239,51 @@ glm::vec3 planeToLineIntersection(
     return q1 + t*(q2-q1);
 }
 
+bool segmentIntersectBox(
+    const glm::vec3 & a, const glm::vec3 & b,
+    const glm::vec3 & mins, const glm::vec3 & maxs
+) {
+    // Slabs test on the segment parameter
+    const glm::vec3 u = b-a;
+    float t0 = 0.0f, t1 = 1.0f;
+    for(int i=0; i<3; i++) {
+        if(u[i] == 0.0f) {
+            if(a[i] < mins[i] || a[i] > maxs[i]) return false;
+            continue;
+        }
+        float tMin = (mins[i]-a[i])/u[i];
+        float tMax = (maxs[i]-a[i])/u[i];
+        if(tMin > tMax) std::swap(tMin, tMax);
+        t0 = glm::max(t0, tMin);
+        t1 = glm::min(t1, tMax);
+        if(t0 > t1) return false;
+    }
+    return true;
+}
+
+bool segmentIntersectTriangle(
+    const glm::vec3 & a, const glm::vec3 & b,
+    const glm::vec3 & p1, const glm::vec3 & p2, const glm::vec3 & p3
+) {
+    // Moller-Trumbore, with the segment as a ray of length 1
+    const float epsilon = 1e-6f;
+    const glm::vec3 u = b-a;
+    const glm::vec3 e1 = p2-p1;
+    const glm::vec3 e2 = p3-p1;
+    const glm::vec3 h = glm::cross(u, e2);
+    const float det = glm::dot(e1, h);
+    if(glm::abs(det) < epsilon*glm::length(u)*glm::length(e1)*glm::length(e2)) return false;
+    const float inv = 1.0f/det;
+    const glm::vec3 s = a-p1;
+    const float x = inv*glm::dot(s, h);
+    if(x < 0.0f || x > 1.0f) return false;
+    const glm::vec3 q = glm::cross(s, e1);
+    const float y = inv*glm::dot(u, q);
+    if(y < 0.0f || x+y > 1.0f) return false;
+    const float t = inv*glm::dot(e2, q);
+    return t > epsilon && t < 1.0f-epsilon;
+}
+
 void lineToLineIntersectionCoef(
     const glm::vec2 & a, const glm::vec2 & u,
     const glm::vec2 & b, const glm::vec2 & v,
@@ -285,7 +332,155 @@ const Geometry::Edge & getChordOnPoint(
     return chords[closestChord];
 }
 
+/*
+Complexity ~ O(N) for N items of the size of a cell.
+*/
+void UniformGrid::build(const std::vector<glm::vec2> & mins, const std::vector<glm::vec2> & maxs) {
+    const unsigned N = mins.size();
+    cellItems.clear();
+    if(N == 0) {
+        origin = glm::vec2(0);
+        cellSize = 1.0f;
+        width = height = 1;
+        cellStart.assign(2, 0);
+        return;
+    }
+
+    glm::vec2 min(FLT_MAX), max(-FLT_MAX);
+    for(unsigned i=0; i<N; i++) {
+        min = glm::min(min, mins[i]);
+        max = glm::max(max, maxs[i]);
+    }
+    origin = min;
+    glm::vec2 extent = max-min;
+    float area = glm::max(extent.x, FLT_EPSILON) * glm::max(extent.y, FLT_EPSILON);
+    cellSize = glm::sqrt(area/N);
+    // No more than 1024 cells in a row for degenerated (flat) sets of items
+    cellSize = glm::max(cellSize, glm::max(extent.x, extent.y)/1024.0f);
+    if(!(cellSize > 0.0f) || !std::isfinite(cellSize)) cellSize = 1.0f;
+    width = int(extent.x/cellSize)+1;
+    height = int(extent.y/cellSize)+1;
+
+    // Counting sort of the items by cell, boxes are slightly enlarged
+    // so that an item on a cell border is in both cells
+    const float margin = 1e-3f*cellSize;
+    auto forEachCell = [&](unsigned i, const std::function<void(unsigned)> & f) {
+        int x0 = cellX(mins[i].x-margin), x1 = cellX(maxs[i].x+margin);
+        int y0 = cellY(mins[i].y-margin), y1 = cellY(maxs[i].y+margin);
+        for(int y=y0; y<=y1; y++) {
+            for(int x=x0; x<=x1; x++) {
+                f(y*width + x);
+            }
+        }
+    };
+    cellStart.assign(width*height+1, 0);
+    for(unsigned i=0; i<N; i++) {
+        forEachCell(i, [&](unsigned c) { cellStart[c+1] += 1; });
+    }
+    for(int c=0; c<width*height; c++) {
+        cellStart[c+1] += cellStart[c];
+    }
+    cellItems.resize(cellStart.back());
+    std::vector<unsigned> fill(cellStart.begin(), cellStart.end()-1);
+    for(unsigned i=0; i<N; i++) {
+        forEachCell(i, [&](unsigned c) { cellItems[fill[c]++] = i; });
+    }
+}
+
+void BVH::build(const std::vector<glm::vec3> & mins, const std::vector<glm::vec3> & maxs) {
+    const unsigned N = mins.size();
+    nodes.clear();
+    items.resize(N);
+    for(unsigned i=0; i<N; i++) items[i] = i;
+    if(N == 0) return;
 
+    std::vector<glm::vec3> centers(N);
+    for(unsigned i=0; i<N; i++) centers[i] = 0.5f*(mins[i]+maxs[i]);
+
+    // Nodes to split, with their range in items
+    struct Range { unsigned node, begin, end; };
+    std::vector<Range> stack;
+    nodes.reserve(2*(N/leafSize)+1);
+    nodes.push_back(Node());
+    stack.push_back({0, 0, N});
+    while(!stack.empty()) {
+        const Range range = stack.back();
+        stack.pop_back();
+
+        glm::vec3 nodeMins(FLT_MAX), nodeMaxs(-FLT_MAX);
+        glm::vec3 centerMins(FLT_MAX), centerMaxs(-FLT_MAX);
+        for(unsigned i=range.begin; i<range.end; i++) {
+            nodeMins = glm::min(nodeMins, mins[items[i]]);
+            nodeMaxs = glm::max(nodeMaxs, maxs[items[i]]);
+            centerMins = glm::min(centerMins, centers[items[i]]);
+            centerMaxs = glm::max(centerMaxs, centers[items[i]]);
+        }
+        nodes[range.node].mins = nodeMins;
+        nodes[range.node].maxs = nodeMaxs;
+
+        if(range.end-range.begin <= leafSize) {
+            nodes[range.node].first = range.begin;
+            nodes[range.node].count = range.end-range.begin;
+            continue;
+        }
+
+        const glm::vec3 extent = centerMaxs-centerMins;
+        int axis = 0;
+        if(extent.y > extent[axis]) axis = 1;
+        if(extent.z > extent[axis]) axis = 2;
+        const unsigned middle = (range.begin+range.end)/2;
+        std::nth_element(
+            items.begin()+range.begin, items.begin()+middle, items.begin()+range.end,
+            [&](unsigned i, unsigned j) { return centers[i][axis] < centers[j][axis]; }
+        );
+
+        const unsigned children = nodes.size();
+        nodes[range.node].first = children;
+        nodes[range.node].count = 0;
+        nodes.push_back(Node());
+        nodes.push_back(Node());
+        stack.push_back({children, range.begin, middle});
+        stack.push_back({children+1, middle, range.end});
+    }
+}
+
+ChordLocator::ChordLocator(
+    const std::vector<glm::vec2> & points,
+    const std::vector<Edge> & chords
+): points(points), chords(chords) {
+    middles.reserve(chords.size());
+    for(auto & c : chords) {
+        middles.push_back(0.5f*(points[c.a] + points[c.b]));
+    }
+    grid.build(middles, middles);
+}
+
+/*
+Complexity ~ O(1) for chords evenly spread around the point.
+*/
+unsigned ChordLocator::getChordIndexOnPoint(const glm::vec2 & p) const {
+    if(middles.empty()) {
+        return UINT_MAX;
+    }
+    if(!std::isfinite(p.x) || !std::isfinite(p.y)) {
+        return 0;
+    }
+
+    unsigned closestChord = UINT_MAX;
+    float minDistance = FLT_MAX;
+    const auto & items = grid.getItems();
+    grid.visitAround(p, minDistance, [&](int x, int y) {
+        for(unsigned k=grid.cellBegin(x, y); k<grid.cellEnd(x, y); k++) {
+            unsigned i = items[k];
+            float distance = glm::distance(p, middles[i]);
+            if(distance < minDistance || (distance == minDistance && i < closestChord)) {
+                minDistance = distance;
+                closestChord = i;
+            }
+        }
+    });
+    return closestChord;
+}
 
 namespace BoundingBox {
 
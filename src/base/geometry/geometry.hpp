@@ -8,6 +8,7 @@
 #include <map>
 #include <algorithm>
 #include <string>
+#include <queue>
 
 #include <utils.hpp>
 
@@ -158,12 +159,233 @@ inline float norm(const glm::vec3 & s1, const glm::vec3 & s2) {
     return glm::sqrt((s1.x-s2.x)*(s1.x-s2.x) + (s1.y-s2.y)*(s1.y-s2.y) + (s1.z-s2.z)*(s1.z-s2.z));
 }
 
+inline glm::vec3 closestPointOnSegment(const glm::vec3 & p, const glm::vec3 & s1, const glm::vec3 & s2) {
+    glm::vec3 u = s2-s1;
+    float l2 = glm::dot(u, u);
+    if(l2 == 0.0f) return s1;
+    return s1 + glm::clamp(glm::dot(p-s1, u)/l2, 0.0f, 1.0f)*u;
+}
+
+/*Distance from p to the box (0 inside).*/
+inline float pointToBoxDistance(const glm::vec3 & p, const glm::vec3 & mins, const glm::vec3 & maxs) {
+    return glm::length(glm::max(glm::max(mins-p, p-maxs), glm::vec3(0)));
+}
+
+bool segmentIntersectBox(
+    const glm::vec3 & a, const glm::vec3 & b,
+    const glm::vec3 & mins, const glm::vec3 & maxs
+);
+
+/*
+True if the segment [a, b] crosses the triangle (p1, p2, p3),
+its extremities excluded.
+*/
+bool segmentIntersectTriangle(
+    const glm::vec3 & a, const glm::vec3 & b,
+    const glm::vec3 & p1, const glm::vec3 & p2, const glm::vec3 & p3
+);
+
 const Geometry::Edge & getChordOnPoint(
     const glm::vec2 & p,
     const std::vector<glm::vec2> & points,
     const std::vector<Geometry::Edge> & chords
 );
 
+/*
+Uniform grid over a set of items given by their bounding boxes,
+with about one item per cell.
+An item is stored in every cell its box overlaps.
+*/
+class UniformGrid {
+public:
+    UniformGrid() {}
+
+    void build(const std::vector<glm::vec2> & mins, const std::vector<glm::vec2> & maxs);
+
+    inline int cellX(float x) const {
+        return glm::clamp(int(glm::floor((x-origin.x)/cellSize)), 0, width-1);
+    }
+    inline int cellY(float y) const {
+        return glm::clamp(int(glm::floor((y-origin.y)/cellSize)), 0, height-1);
+    }
+
+    // Items of the cell (x, y) are getItems()[cellBegin(x, y)] to getItems()[cellEnd(x, y)-1]
+    inline unsigned cellBegin(int x, int y) const { return cellStart[y*width + x]; }
+    inline unsigned cellEnd(int x, int y) const { return cellStart[y*width + x + 1]; }
+    inline const std::vector<unsigned> & getItems() const { return cellItems; }
+
+    /*
+    Visit the cells ring by ring around p, calling visit(x, y) for each cell,
+    until bestDistance (updated by visit) is smaller than the distance
+    from p to the cells not visited yet.
+    */
+    template<typename Visit>
+    void visitAround(const glm::vec2 & p, const float & bestDistance, Visit visit) const {
+        const int cx = cellX(p.x);
+        const int cy = cellY(p.y);
+        // Margin for the rounding of the cells bounds
+        const float margin = 1e-3f*cellSize;
+        for(int r=0; ; r++) {
+            int x0 = cx-r, x1 = cx+r, y0 = cy-r, y1 = cy+r;
+            for(int x=glm::max(x0, 0); x<=glm::min(x1, width-1); x++) {
+                if(y0 >= 0) visit(x, y0);
+                if(y1 < height && y1 != y0) visit(x, y1);
+            }
+            for(int y=glm::max(y0+1, 0); y<=glm::min(y1-1, height-1); y++) {
+                if(x0 >= 0) visit(x0, y);
+                if(x1 < width && x1 != x0) visit(x1, y);
+            }
+
+            if(x0 <= 0 && y0 <= 0 && x1 >= width-1 && y1 >= height-1) break;
+            // Cells further than the ring r are at least at this distance from p
+            float bound = glm::min(
+                glm::min(p.x - (origin.x + x0*cellSize), (origin.x + (x1+1)*cellSize) - p.x),
+                glm::min(p.y - (origin.y + y0*cellSize), (origin.y + (y1+1)*cellSize) - p.y)
+            ) - margin;
+            if(bestDistance < bound) break;
+        }
+    }
+
+private:
+    glm::vec2 origin = glm::vec2(0);
+    float cellSize = 1.0f;
+    int width = 1;
+    int height = 1;
+
+    std::vector<unsigned> cellStart = std::vector<unsigned>(2, 0);
+    std::vector<unsigned> cellItems;
+};
+
+/*
+Grid of the chords middle points.
+Answers getChordOnPoint queries by visiting the cells around the point
+ring by ring, instead of scanning all the chords.
+Gives the same chord as getChordOnPoint (the first one in case of tie).
+The points and chords must outlive the locator.
+*/
+class ChordLocator {
+public:
+    ChordLocator(
+        const std::vector<glm::vec2> & points,
+        const std::vector<Edge> & chords
+    );
+
+    /*Index in the chords of the closest chord to p, UINT_MAX if there is no chord.*/
+    unsigned getChordIndexOnPoint(const glm::vec2 & p) const;
+
+    /*The locator must not be empty.*/
+    inline const Edge & getChordOnPoint(const glm::vec2 & p) const {
+        return chords.at(getChordIndexOnPoint(p));
+    }
+
+    inline bool isEmpty() const { return chords.empty(); }
+
+    inline const std::vector<glm::vec2> & getPoints() const { return points; }
+    inline const std::vector<Edge> & getChords() const { return chords; }
+
+private:
+    const std::vector<glm::vec2> & points;
+    const std::vector<Edge> & chords;
+
+    std::vector<glm::vec2> middles;
+    UniformGrid grid;
+};
+
+/*
+Bounding volume hierarchy over a set of 3D items given by their bounding boxes.
+Nodes are split at the median of their longest axis,
+leaves hold up to leafSize items.
+*/
+class BVH {
+public:
+    static const unsigned leafSize = 4;
+
+    struct Node {
+        glm::vec3 mins, maxs;
+        // Leaf : getItems()[first] to getItems()[first+count-1]
+        // Inner node (count == 0) : children nodes first and first+1
+        unsigned first, count;
+    };
+
+    BVH() {}
+
+    void build(const std::vector<glm::vec3> & mins, const std::vector<glm::vec3> & maxs);
+
+    inline const std::vector<Node> & getNodes() const { return nodes; }
+    inline const std::vector<unsigned> & getItems() const { return items; }
+
+    /*
+    Call visit(item) for the items of the nodes for which overlaps(mins, maxs)
+    is true, until visit returns true. Returns true if it did.
+    */
+    template<typename Overlaps, typename Visit>
+    bool findAny(Overlaps overlaps, Visit visit) const {
+        if(nodes.empty()) return false;
+        std::vector<unsigned> stack(1, 0);
+        while(!stack.empty()) {
+            const Node & node = nodes[stack.back()];
+            stack.pop_back();
+            if(!overlaps(node.mins, node.maxs)) continue;
+            if(node.count == 0) {
+                stack.push_back(node.first);
+                stack.push_back(node.first+1);
+                continue;
+            }
+            for(unsigned i=node.first; i<node.first+node.count; i++) {
+                if(visit(items[i])) return true;
+            }
+        }
+        return false;
+    }
+
+    /*
+    Call visit(item) for the items by increasing itemDistance(item), the
+    smallest item index first in case of tie, until visit returns true.
+    nodeDistance(mins, maxs) must not be more than the distance of an item in the box.
+    Returns the item for which visit returned true, UINT_MAX if none.
+    */
+    template<typename NodeDistance, typename ItemDistance, typename Visit>
+    unsigned visitClosest(NodeDistance nodeDistance, ItemDistance itemDistance, Visit visit) const {
+        if(nodes.empty()) return UINT_MAX;
+
+        struct Entry {
+            float distance;
+            bool isItem;
+            unsigned index;
+            // Nodes first at equal distance, they can hold a smaller item index
+            bool operator>(const Entry & o) const {
+                if(distance != o.distance) return distance > o.distance;
+                if(isItem != o.isItem) return isItem;
+                return index > o.index;
+            }
+        };
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> queue;
+        queue.push({nodeDistance(nodes[0].mins, nodes[0].maxs), false, 0});
+        while(!queue.empty()) {
+            Entry entry = queue.top();
+            queue.pop();
+            if(entry.isItem) {
+                if(visit(entry.index)) return entry.index;
+                continue;
+            }
+            const Node & node = nodes[entry.index];
+            if(node.count == 0) {
+                for(unsigned c=node.first; c<node.first+2; c++) {
+                    queue.push({nodeDistance(nodes[c].mins, nodes[c].maxs), false, c});
+                }
+                continue;
+            }
+            for(unsigned i=node.first; i<node.first+node.count; i++) {
+                queue.push({itemDistance(items[i]), true, items[i]});
+            }
+        }
+        return UINT_MAX;
+    }
+
+private:
+    std::vector<Node> nodes;
+    std::vector<unsigned> items;
+};
 
 namespace BoundingBox {
 
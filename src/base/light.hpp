@@ -6,6 +6,8 @@
 #include <frame-buffer.hpp>
 
 #define MAP_TEXTURE_UNIT_DEPTH_MAP 4
+#define UNIFORM_BLOCK_BINDING_LIGHTS 2
+#define MAX_LIGHTS 10
 
 /*
 Holds a light source data :
@@ -16,6 +18,30 @@ And methods to send uniform to the GPU for the Phong shader program.
 class Light {
     friend class Renderer;
     friend class Mesh;
+public:
+    /*A light of the Lights uniform block (std140 layout).*/
+    struct UniformData {
+        glm::vec3 pos; float atteConst;
+        glm::vec3 diffuseColor; float atteLin;
+        glm::vec3 specularColor; float atteQuad;
+        glm::vec3 ambientColor; float camNear;
+        glm::vec3 camUp; float camFar;
+        glm::vec3 lookAt; float fovAngleDegree;
+        glm::mat4 shadowProjViewMat;
+        GLuint isSpotLight;
+        GLuint isShadowCaster;
+        GLuint padding[2];
+    };
+
+    /*The Lights uniform block, uploaded once per frame.*/
+    struct UniformBlock {
+        UniformData lights[MAX_LIGHTS];
+        GLuint lightCount;
+        GLuint padding[3];
+    };
+    static_assert(sizeof(UniformData) == 176, "Light std140 layout");
+    static_assert(sizeof(UniformBlock) % 16 == 0, "Lights block std140 size");
+
 protected:
     glm::vec3 lightPos;
     glm::vec3 lightAmbientColor;
@@ -32,25 +58,6 @@ protected:
     float lightFovAngleDegree = 180.0f;
     glm::vec3 lightLookAt = {0.0f, 0.0f, 0.0f};
 
-    void buildUniformNames(int indexInLightsBuffer);
-
-    char * uniformNamePos = nullptr;
-    char * uniformNameAmbientColor = nullptr;
-    char * uniformNameDiffuseColor = nullptr;
-    char * uniformNameSpecularColor = nullptr;
-    char * uniformNameAtteConst = nullptr;
-    char * uniformNameAtteLin = nullptr;
-    char * uniformNameAtteQuad = nullptr;
-    char * uniformNameCamNear = nullptr;
-    char * uniformNameCamFar = nullptr;
-    char * uniformNameCamUp = nullptr;
-    char * uniformNameFovAngleDegree = nullptr;
-    char * uniformNameLookAt = nullptr;
-    char * uniformNameShadowMap = nullptr;
-    char * uniformNameShadowProjViewMat = nullptr;
-    char * uniformNameIsSpotLight = nullptr;
-    char * uniformNameIsShadowCaster = nullptr;
-
     FrameBuffer depthFrameBuffer;
     glm::mat4 shadowProjViewMat;
 
@@ -61,28 +68,13 @@ protected:
     void updateFromLightDepthUniforms();
     void bindDepthFrameBuffer();
 
-    void updateUniforms(GLuint program, unsigned lightIndex);
+    void getUniformData(UniformData & data) const;
+    void bindShadowMap(unsigned lightIndex);
 
 public:
     Light() {
         Program::getInstanceShadowMap()->subscribe();
     }
-    ~Light() {
-        if(uniformNamePos) delete uniformNamePos;
-        if(uniformNameAmbientColor) delete uniformNameAmbientColor;
-        if(uniformNameDiffuseColor) delete uniformNameDiffuseColor;
-        if(uniformNameSpecularColor) delete uniformNameSpecularColor;
-        if(uniformNameAtteConst) delete uniformNameAtteConst;
-        if(uniformNameAtteLin) delete uniformNameAtteLin;
-        if(uniformNameAtteQuad) delete uniformNameAtteQuad;
-        if(uniformNameCamNear) delete uniformNameCamNear;
-        if(uniformNameCamFar) delete uniformNameCamFar;
-        if(uniformNameCamUp) delete uniformNameCamUp;
-        if(uniformNameFovAngleDegree) delete uniformNameFovAngleDegree;
-        if(uniformNameLookAt) delete uniformNameLookAt;
-        if(uniformNameIsSpotLight) delete uniformNameIsSpotLight;
-        if(uniformNameIsShadowCaster) delete uniformNameIsShadowCaster;
-    }
 
     inline Light * setSpot(
         float near = 0.1f, float far =  5.0f, float fovAngleDegree  = 120.0f,
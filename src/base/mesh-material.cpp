@@ -80,25 +80,21 @@ MeshMaterial * MeshMaterial::meshGetTextureMaterial(
 }
 
 void MeshMaterial::updateUniforms(
-  const glm::mat4 & viewMatrix,
-  const glm::mat4 & projMatrix,
   const glm::mat4 & worldMatrix,
-  GLuint program = 0
+  Program & program
 ) {
-  glUniformMatrix4fv(glGetUniformLocation(program, "viewMat"), 1, GL_FALSE, glm::value_ptr(viewMatrix));
-  glUniformMatrix4fv(glGetUniformLocation(program, "projMat"), 1, GL_FALSE, glm::value_ptr(projMatrix));
-  glUniformMatrix4fv(glGetUniformLocation(program, "worldMat"), 1, GL_FALSE, glm::value_ptr(worldMatrix));
+  glUniformMatrix4fv(program.getUniformLocation(Program::UniformWorldMat), 1, GL_FALSE, glm::value_ptr(worldMatrix));
   getOpenGLError("uniform matrices");
 
-  glUniform3f(glGetUniformLocation(program, "basicColor"), basicColor.r, basicColor.g, basicColor.b);
-  glUniform3f(glGetUniformLocation(program, "diffuseColor"), diffuseColor.r, diffuseColor.g, diffuseColor.b);
-  glUniform3f(glGetUniformLocation(program, "specularColor"), specularColor.r, specularColor.g, specularColor.b);
-  glUniform1ui(glGetUniformLocation(program, "shininess"), shininess);
+  glUniform3f(program.getUniformLocation(Program::UniformBasicColor), basicColor.r, basicColor.g, basicColor.b);
+  glUniform3f(program.getUniformLocation(Program::UniformDiffuseColor), diffuseColor.r, diffuseColor.g, diffuseColor.b);
+  glUniform3f(program.getUniformLocation(Program::UniformSpecularColor), specularColor.r, specularColor.g, specularColor.b);
+  glUniform1ui(program.getUniformLocation(Program::UniformShininess), shininess);
   getOpenGLError("uniform colors");
 
   if(diffuseMap) {
     diffuseMap->bind(MAP_TEXTURE_UNIT_DIFFUSE);
-    glUniform1i(glGetUniformLocation(program, "diffuseMap"), MAP_TEXTURE_UNIT_DIFFUSE);
+    glUniform1i(program.getUniformLocation(Program::UniformDiffuseMap), MAP_TEXTURE_UNIT_DIFFUSE);
     getOpenGLError("uniform diffuse map");
   }
   else {
@@ -107,7 +103,7 @@ void MeshMaterial::updateUniforms(
   }
   if(specularMap) {
     specularMap->bind(MAP_TEXTURE_UNIT_SPECULAR);
-    glUniform1i(glGetUniformLocation(program, "specularMap"), MAP_TEXTURE_UNIT_SPECULAR);
+    glUniform1i(program.getUniformLocation(Program::UniformSpecularMap), MAP_TEXTURE_UNIT_SPECULAR);
     getOpenGLError("uniform specular map");
   }
   else  {
@@ -116,7 +112,7 @@ void MeshMaterial::updateUniforms(
   }
   if(shininessMap) {
     shininessMap->bind(MAP_TEXTURE_UNIT_SHININESS);
-    glUniform1i(glGetUniformLocation(program, "shininessMap"), MAP_TEXTURE_UNIT_SHININESS);
+    glUniform1i(program.getUniformLocation(Program::UniformShininessMap), MAP_TEXTURE_UNIT_SHININESS);
     getOpenGLError("uniform shininess map");
   }
   else {
@@ -125,7 +121,7 @@ void MeshMaterial::updateUniforms(
   }
   if(normalMap) {
     normalMap->bind(MAP_TEXTURE_UNIT_NORMAL);
-    glUniform1i(glGetUniformLocation(program, "normalMap"), MAP_TEXTURE_UNIT_NORMAL);
+    glUniform1i(program.getUniformLocation(Program::UniformNormalMap), MAP_TEXTURE_UNIT_NORMAL);
     getOpenGLError("uniform normal map");
   }
   else {
@@ -35,8 +35,7 @@ public:
     }
 
     /*Update uniforms in GPU.*/
-    void updateUniforms(
-        const glm::mat4 & viewMatrix, const glm::mat4 & projMatrix, const glm::mat4 & worldMatrix, GLuint program);
+    void updateUniforms(const glm::mat4 & worldMatrix, Program & program);
     
     static MeshMaterial * meshGetSimplePhongMaterial(
         const glm::vec3 & diffuseColor, const glm::vec3 & specularColor, unsigned int shininess);
@@ -1,33 +1,19 @@
 #include "mesh-skeleton.hpp"
 
-#include <mesh.hpp>
-
 MeshSkeleton::MeshSkeleton(
   const Rigging & rigging
 ) {
   bones.reserve(rigging.getBones().size());
   for(unsigned i=0; i<rigging.getBones().size(); i++) {
     const auto & bone = rigging.getBones()[i];
-    const auto & boneSkin = ((Rigging&)rigging).getBonesSkins()[i];
 
     MeshBone meshBone;
     meshBone.A = bone.getA().getPoint();
     meshBone.B = bone.getB().getPoint();
     meshBone.parentIndexPlusOne = 0;
     meshBone.mat = glm::mat4(1);
-    meshBone.verticesWeights = std::vector<float>();
-    meshBone.verticesWeights.resize(
-      boneSkin.getVertexSkinWeights().size(),
-      0.0f
-    );
-    for(const auto & w : boneSkin.getVertexSkinWeights()) {
-      meshBone.verticesWeights[w.first] = w.second;
-    }
     bones.push_back(meshBone);
-
-    verticesCount = boneSkin.getVertexSkinWeights().size();
   }
-
   for(unsigned i=0; i<rigging.getBones().size(); i++) {
     MeshBone * meshBone = &(bones.at(i));
     const auto & bone = rigging.getBones()[i];
@@ -42,128 +28,99 @@ MeshSkeleton::MeshSkeleton(
     }
   }
 
-  vertexTransformCoefs = new float[bones.size()*verticesCount*textureElemSize*textureElemSize];
-  memset(
-      vertexTransformCoefs,
-      0,
-      sizeof(float)*bones.size()*verticesCount*textureElemSize*textureElemSize
-  );
-}
-
-void MeshSkeleton::updateUniform(GLuint program) {
-  glUniform1ui(glGetUniformLocation(program, "bonesCount"), bones.size());
-  getOpenGLError("bones count uniform");
-
-  glUniform1ui(glGetUniformLocation(program, "verticesCount"), verticesCount);
-  getOpenGLError("vertices count uniform");
-
-  glUniform1ui(glGetUniformLocation(program, "textureElemSize"), textureElemSize);
-  getOpenGLError("texture elem size");
-
+  // Parents before their children, a parent loop is cut where it is found
+  std::vector<unsigned char> state(bones.size(), 0); // new, in the chain, sorted
   for(unsigned b=0; b<bones.size(); b++) {
-    auto name = buildIndexedString("bones[", b, "].A");
-    glUniform3f(
-      glGetUniformLocation(
-        program, name
-      ),
-      bones[b].A.x, bones[b].A.y, bones[b].A.z
-    );
-    delete name;
-
-    name = buildIndexedString("bones[", b, "].rotationMat");
-    glUniformMatrix4fv(
-      glGetUniformLocation(
-        program, name
-      ),
-      1, GL_FALSE,
-      glm::value_ptr(bones[b].mat)
-    );
-    delete name;
-
-    name = buildIndexedString("bones[", b, "].parentIndexPlusOne");
-    glUniform1ui(glGetUniformLocation(program, name), bones[b].parentIndexPlusOne);
-    delete name;
+    std::vector<unsigned> chain;
+    unsigned c = b;
+    while(state[c] == 0) {
+      state[c] = 1;
+      chain.push_back(c);
+      unsigned parent = bones[c].parentIndexPlusOne;
+      if(parent == 0) break;
+      if(state[parent-1] == 1) {
+        bones[c].parentIndexPlusOne = 0;
+        break;
+      }
+      c = parent-1;
+    }
+    for(auto it=chain.rbegin(); it!=chain.rend(); it++) {
+      state[*it] = 2;
+      hierarchyOrder.push_back(*it);
+    }
+  }
+  bonesMatrices.assign(bones.size(), glm::mat4(1));
+  if(bones.size() > MAX_SKELETON_BONES) {
+    std::cerr << "Only the first " << MAX_SKELETON_BONES << " bones of "
+      << bones.size() << " are animated" << std::endl;
   }
 
-  vertexTransformCoefsTexture.bind(MAP_TEXTURE_VERTEX_TRANSFORM_COEF);
-  glUniform1i(glGetUniformLocation(program, "vertexTransformCoef"), MAP_TEXTURE_VERTEX_TRANSFORM_COEF);
+  static_assert(SkinWeights::influencesCount == 4, "Skinning attributes are uvec4 and vec4");
+  const auto & skin = rigging.getSkinWeights();
+  const unsigned verticesCount = skin.getVerticesCount();
+  vertexBoneIds.resize(verticesCount);
+  vertexWeights.resize(verticesCount);
+  for(unsigned v=0; v<verticesCount; v++) {
+    for(unsigned i=0; i<4; i++) {
+      vertexBoneIds[v][i] = skin.getBoneIndices()[v*4+i];
+      vertexWeights[v][i] = skin.getWeights()[v*4+i];
+    }
+  }
 }
 
-void MeshSkeleton::initVerticesTranformsCoef() {
-  if(vertexTransformCoefs && verticesCount >  0) {
-    vertexTransformCoefsTexture.interpolateToNearest = true;
-    vertexTransformCoefsTexture.initFromData(
-      vertexTransformCoefs,
-      verticesCount*textureElemSize,
-      bones.size()*textureElemSize
-      , 1, false
-    );
+MeshSkeleton::~MeshSkeleton() {
+  if(bonesMatricesUbo) {
+    glDeleteBuffers(1, &bonesMatricesUbo);
+    bonesMatricesUbo = 0;
   }
 }
 
-void MeshSkeleton::setVerticesCoef(unsigned transformIndex, unsigned vertexIndex, float value) {
-  for(unsigned i=0; i<textureElemSize; i++) {
-    for(unsigned j=0; j<textureElemSize; j++) {
-      vertexTransformCoefs[
-          ((transformIndex*textureElemSize+i) * verticesCount*textureElemSize)
-          + (vertexIndex*textureElemSize+j)
-      ] = value;
+/*
+Forward kinematics : each bone rotates around its point A,
+then follows the transform of its parent.
+*/
+void MeshSkeleton::computeBonesMatrices() {
+  for(unsigned b : hierarchyOrder) {
+    const auto & bone = bones[b];
+    glm::mat4 local =
+      glm::translate(glm::mat4(1), bone.A)
+      * bone.mat
+      * glm::translate(glm::mat4(1), -bone.A);
+    if(bone.parentIndexPlusOne > 0) {
+      bonesMatrices[b] = bonesMatrices[bone.parentIndexPlusOne-1] * local;
+    }
+    else {
+      bonesMatrices[b] = local;
     }
   }
 }
 
-std::vector<Renderable*> & MeshSkeleton::getSkeletonMesh(const glm::vec3 & color) {
-  boneMeshes.clear();
-  for(int i=0; i<bones.size(); i++) {
-    auto & bone = bones.at(i);
-
-    std::vector<glm::vec3> triangles;
-    std::vector<glm::vec3> colors;
-
-    auto v = glm::cross(bone.A-bone.B, glm::vec3(0,0,1));
-    v = glm::normalize(v);
-    
-    triangles.push_back(glm::vec3(0));
-    triangles.push_back(bone.B+glm::vec3(0, 0, 0.02)-bone.A);
-    triangles.push_back(bone.B+glm::vec3(0, 0, -0.02)-bone.A);
-
-    triangles.push_back(glm::vec3(0));
-    triangles.push_back(bone.B+v*0.02f-bone.A);
-    triangles.push_back(bone.B+glm::vec3(0, 0, 0.02)-bone.A);
-
-    triangles.push_back(glm::vec3(0));
-    triangles.push_back(bone.B+v*0.02f-bone.A);
-    triangles.push_back(bone.B+glm::vec3(0, 0, -0.02)-bone.A);
-    
-    colors.push_back(color);
-    colors.push_back(color);
-    colors.push_back(color);
-    colors.push_back(color);
-    colors.push_back(color);
-    colors.push_back(color);
-    colors.push_back(color);
-    colors.push_back(color);
-    colors.push_back(color);
-    
-    std::vector<glm::uvec3> faces;
-    Mesh * m = new Mesh(
-      new MeshGeometry(triangles, faces, colors),
-      MeshMaterial::meshGetSimplePhongMaterial(color*0.f, color*0.f, 5)
-    );
-    m->setPosition(bone.A);
-    boneMeshes.push_back(m);
+const std::vector<glm::mat4> & MeshSkeleton::getBonesMatrices() {
+  if(bonesMatricesChanged) {
+    computeBonesMatrices();
+    bonesMatricesChanged = false;
   }
+  return bonesMatrices;
+}
 
-  for(int i=0; i<bones.size(); i++) {
-    auto & bone = bones.at(i);
-    Mesh * mesh = (Mesh*)boneMeshes.at(i);
-    if(bone.parentIndexPlusOne > 0) {
-      mesh->setParent((Mesh*)boneMeshes.at(bone.parentIndexPlusOne-1));
-      mesh->translateMesh(-(mesh->getCompleteParentPosition()));
-    }
+void MeshSkeleton::updateUniform(Program & program) {
+  const unsigned count = glm::min(unsigned(bones.size()), unsigned(MAX_SKELETON_BONES));
+  if(!bonesMatricesUbo) {
+    glGenBuffers(1, &bonesMatricesUbo);
+    glBindBuffer(GL_UNIFORM_BUFFER, bonesMatricesUbo);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(glm::mat4)*MAX_SKELETON_BONES, nullptr, GL_DYNAMIC_DRAW);
+    uboOutdated = true;
+  }
+  if(uboOutdated) {
+    glBindBuffer(GL_UNIFORM_BUFFER, bonesMatricesUbo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(glm::mat4)*count, getBonesMatrices().data());
+    uboOutdated = false;
   }
+  glBindBufferBase(GL_UNIFORM_BUFFER, UNIFORM_BLOCK_BINDING_BONES, bonesMatricesUbo);
+  getOpenGLError("bones matrices uniform block");
 
-  return boneMeshes;
+  glUniform1ui(program.getUniformLocation(Program::UniformBonesCount), count);
+  getOpenGLError("bones count uniform");
 }
 
 void MeshSkeleton::rotateBoneArroundA(unsigned boneIndex, const glm::vec3 & angles) {
@@ -173,6 +130,7 @@ void MeshSkeleton::rotateBoneArroundA(unsigned boneIndex, const glm::vec3 & angl
   rot = glm::rotate(rot, angles.y, glm::vec3(0.f, 1.f, 0.f));
   rot = glm::rotate(rot, angles.z, glm::vec3(0.f, 0.f, 1.f));
   bones.at(boneIndex).mat = rot;
-
-  ((Mesh*)boneMeshes.at(boneIndex))->setOrientation(angles);
+  bonesMatricesChanged = true;
+  uboOutdated = true;
+  bonesVersion++;
 }
@@ -4,18 +4,17 @@
 #include <utils.hpp>
 #include <modeling/skeleton.hpp>
 #include <modeling/rigging.hpp>
-#include <texture.hpp>
 #include <base.hpp>
 
-#define MAP_TEXTURE_VERTEX_TRANSFORM_COEF 4
+#define UNIFORM_BLOCK_BINDING_BONES 0
+// 16KB of matrices, the minimum uniform block size of OpenGL
+#define MAX_SKELETON_BONES 256
 
 struct MeshBone {
   glm::vec3 A;
   glm::vec3 B;
   glm::mat4 mat; // Rotation arround A
 
-  std::vector<float> verticesWeights;
-
   unsigned parentIndexPlusOne;
 };
 
@@ -24,30 +23,45 @@ public:
   MeshSkeleton(
     const Rigging & rigging
   );
+  MeshSkeleton(const MeshSkeleton &) = delete;
+  MeshSkeleton & operator=(const MeshSkeleton &) = delete;
 
-  void setVerticesCoef(unsigned transformIndex, unsigned vertexIndex, float value);
-  void initVerticesTranformsCoef();
-  void updateUniform(GLuint program);
+  ~MeshSkeleton();
 
-  inline std::vector<MeshBone> & getBones() { return bones; }
+  /*
+  Binds the bone matrices uniform block, uploading the matrices first
+  if a bone moved since the last call.
+  */
+  void updateUniform(Program & program);
 
-  std::vector<Renderable*> & getSkeletonMesh(
-    const glm::vec3 & color
-  );
+  inline const std::vector<MeshBone> & getBones() const { return bones; }
+
+  /*Transform of each bone, its parents' ones included.*/
+  const std::vector<glm::mat4> & getBonesMatrices();
+  /*Changes each time a bone moves.*/
+  inline unsigned getBonesVersion() const { return bonesVersion; }
+
+  /*Skinning vertex attributes : the bones of each vertex and their weights.*/
+  inline const std::vector<glm::uvec4> & getVertexBoneIds() const { return vertexBoneIds; }
+  inline const std::vector<glm::vec4> & getVertexWeights() const { return vertexWeights; }
 
   void rotateBoneArroundA(unsigned boneIndex, const glm::vec3 & angles);
 
 private:
   std::vector<MeshBone> bones;
+  // Bones indices, each parent before its children
+  std::vector<unsigned> hierarchyOrder;
 
-  unsigned verticesCount = 0;
+  std::vector<glm::mat4> bonesMatrices;
+  bool bonesMatricesChanged = true;
+  unsigned bonesVersion = 0;
+  GLuint bonesMatricesUbo = 0;
+  bool uboOutdated = true;
 
-  std::vector<Renderable*> boneMeshes;
+  void computeBonesMatrices();
 
-  /*Each row is a transform. each column is a vertex.*/
-  float * vertexTransformCoefs = nullptr;
-  FloatTexture vertexTransformCoefsTexture;
-  unsigned textureElemSize = 3;
+  std::vector<glm::uvec4> vertexBoneIds;
+  std::vector<glm::vec4> vertexWeights;
 };
 
 #endif
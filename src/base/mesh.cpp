@@ -3,35 +3,23 @@
 #define _USE_MATH_DEFINES
 
 // The main rendering call
-void Mesh::render(Renderer & renderer, GLuint program = 0,
+void Mesh::render(Renderer & renderer, Program & program,
   const glm::mat4 & extraTransformFirst = glm::mat4(1),
   const glm::mat4 & extraTransformLast = glm::mat4(1))
 {
   if(!shouldRender) return;
   
-  const glm::mat4 viewMatrix = renderer.getCamera().computeViewMatrix();
-  const glm::mat4 projMatrix = renderer.getCamera().computeProjectionMatrix();
   const glm::mat4 worldMatrix = extraTransformLast * getWorldMatrix() * extraTransformFirst;
 
-  getOpenGLError("using program");
-  // Camera position
-  const auto cameraPos = renderer.getCamera().getPosition();
-  glUniform3f(glGetUniformLocation(program, "cameraPos"), cameraPos.x, cameraPos.y, cameraPos.z);
-  // Material data
-  material->updateUniforms(viewMatrix, projMatrix, worldMatrix, program);
-  // Lights data
-  glUniform1ui(glGetUniformLocation(program, "lightCount"), renderer.getLights().size());
-  getOpenGLError("uniform light count");
-  for(unsigned i=0; i<renderer.getLights().size(); i++) {
-    renderer.getLights()[i]->updateUniforms(program, i);
-  }
+  // The camera and the lights are in the uniform blocks of the frame
+  material->updateUniforms(worldMatrix, program);
 
   if(skeleton!=nullptr) {
     skeleton->updateUniform(program);
-    glUniform1i(glGetUniformLocation(program, "hasBones"), true);
+    glUniform1i(program.getUniformLocation(Program::UniformHasBones), true);
   }
   else {
-    glUniform1i(glGetUniformLocation(program, "hasBones"), false);
+    glUniform1i(program.getUniformLocation(Program::UniformHasBones), false);
   }
 
   glBindVertexArray(m_vao);
@@ -117,6 +105,42 @@ void Mesh::initVertexTexCoord() {
   getOpenGLError("vertex texture coordinates attrib");
 }
 
+/*
+Bones and weights of the 4 influences of each vertex, uploaded once :
+the vertex shader only reads the bones of the vertex.
+*/
+void Mesh::initVertexSkinning() {
+  const auto & boneIds = skeleton->getVertexBoneIds();
+  const auto & weights = skeleton->getVertexWeights();
+  if(boneIds.size() != geometry->getVertexPositionsCount()) {
+    std::cerr << "Skinning attributes do not match the mesh vertices" << std::endl;
+    return;
+  }
+#ifdef _MY_OPENGL_IS_33_
+  if(!m_boneIdsVbo) glGenBuffers(1, &m_boneIdsVbo);
+  glBindBuffer(GL_ARRAY_BUFFER, m_boneIdsVbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(glm::uvec4)*boneIds.size(), boneIds.data(), GL_STATIC_DRAW);
+  glVertexAttribIPointer(4, 4, GL_UNSIGNED_INT, sizeof(glm::uvec4), 0);
+  glEnableVertexAttribArray(4);
+
+  if(!m_boneWeightsVbo) glGenBuffers(1, &m_boneWeightsVbo);
+  glBindBuffer(GL_ARRAY_BUFFER, m_boneWeightsVbo);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec4)*weights.size(), weights.data(), GL_STATIC_DRAW);
+  glVertexAttribPointer(5, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), 0);
+  glEnableVertexAttribArray(5);
+#endif
+  getOpenGLError("vertex skinning attribs");
+}
+
+void Mesh::setSkeleton(MeshSkeleton * skeleton) {
+  this->skeleton = skeleton;
+  if(isInitiliazed && skeleton) {
+    glBindVertexArray(m_vao);
+    initVertexSkinning();
+    glBindVertexArray(0);
+  }
+}
+
 void Mesh::initTriangleIndices() {
   size_t length = sizeof(unsigned int)*(geometry->getFacesVCount());
 #ifdef _MY_OPENGL_IS_33_
@@ -153,6 +177,9 @@ void Mesh::init() {
   if(geometry->hasFaces() && geometry->getFaces().size() > 0) {
     initTriangleIndices();
   }
+  if(skeleton) {
+    initVertexSkinning();
+  }
 
   glBindVertexArray(0);
   
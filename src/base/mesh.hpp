@@ -40,6 +40,14 @@ public:
             glDeleteBuffers(1, &m_texCoordVbo);
             m_texCoordVbo = 0;
         }
+        if(m_boneIdsVbo) {
+            glDeleteBuffers(1, &m_boneIdsVbo);
+            m_boneIdsVbo = 0;
+        }
+        if(m_boneWeightsVbo) {
+            glDeleteBuffers(1, &m_boneWeightsVbo);
+            m_boneWeightsVbo = 0;
+        }
         if(m_ibo) {
             glDeleteBuffers(1, &m_ibo);
             m_ibo = 0;
@@ -47,7 +55,7 @@ public:
     }
 
     void init() override;
-    void render(Renderer & renderer, GLuint program,
+    void render(Renderer & renderer, Program & program,
         const glm::mat4 & extraTransformFirst,
         const glm::mat4 & extraTransformLast)  override;
 
@@ -64,9 +72,8 @@ public:
         return getWorldMatrix();
     }
 
-    inline void setSkeleton(MeshSkeleton * skeleton) {
-        this->skeleton = skeleton;
-    }
+    /*The skinning attributes are uploaded now if the mesh is already on the GPU.*/
+    void setSkeleton(MeshSkeleton * skeleton);
 
     bool shouldRender = true;
 
@@ -75,6 +82,7 @@ protected:
     void initVertexNormals();
     void initVertexColors();
     void initVertexTexCoord();
+    void initVertexSkinning();
     void initTriangleIndices();
 
     bool isInitiliazed = false;
@@ -87,6 +95,8 @@ protected:
     GLuint m_normalVbo = 0;
     GLuint m_colorVbo = 0;
     GLuint m_texCoordVbo = 0;
+    GLuint m_boneIdsVbo = 0;
+    GLuint m_boneWeightsVbo = 0;
     GLuint m_ibo = 0;
 };
 
@@ -0,0 +1,92 @@
+#include "bone-heat-solver.hpp"
+
+#include <parallel.hpp>
+
+BoneHeatSolver::BoneHeatSolver(
+    const std::vector<glm::vec3> & vertices,
+    const std::vector<glm::uvec3> & faces
+) {
+    const unsigned N = vertices.size();
+    areas = Eigen::VectorXd::Zero(N);
+
+    std::vector<Eigen::Triplet<double>> triplets;
+    triplets.reserve(faces.size()*12);
+    double totalArea = 0;
+    for(auto & face : faces) {
+        const unsigned ids[3] = {face.x, face.y, face.z};
+        const glm::dvec3 p[3] = {
+            glm::dvec3(vertices[face.x]), glm::dvec3(vertices[face.y]), glm::dvec3(vertices[face.z])
+        };
+        const double doubleArea = glm::length(glm::cross(p[1]-p[0], p[2]-p[0]));
+        // Degenerated triangles have no cotangent
+        if(!(doubleArea > 1e-12)) continue;
+
+        for(unsigned c=0; c<3; c++) {
+            areas[ids[c]] += doubleArea/6.0;
+            // Edge (i, j) opposite to the corner c
+            const unsigned i = ids[(c+1)%3];
+            const unsigned j = ids[(c+2)%3];
+            const glm::dvec3 u = p[(c+1)%3]-p[c];
+            const glm::dvec3 v = p[(c+2)%3]-p[c];
+            const double w = 0.5*glm::dot(u, v)/doubleArea;
+            triplets.emplace_back(i, j, -w);
+            triplets.emplace_back(j, i, -w);
+            triplets.emplace_back(i, i, w);
+            triplets.emplace_back(j, j, w);
+        }
+        totalArea += doubleArea/2.0;
+    }
+    // Vertices out of any triangle still need an area to be heated
+    const double minArea = 1e-6*totalArea/glm::max(N, 1u);
+    for(unsigned i=0; i<N; i++) {
+        areas[i] = glm::max(areas[i], minArea);
+    }
+
+    laplacian.resize(N, N);
+    laplacian.setFromTriplets(triplets.begin(), triplets.end());
+    // Every diagonal entry is stored, the heats are added to them
+    for(unsigned i=0; i<N; i++) {
+        laplacian.coeffRef(i, i) += 0.0;
+    }
+    laplacian.makeCompressed();
+}
+
+bool BoneHeatSolver::solve(
+    const std::vector<float> & heats,
+    const std::vector<unsigned> & closestBones,
+    unsigned bonesCount,
+    std::vector<std::vector<float>> & weights
+) {
+    const unsigned N = areas.size();
+    SparseMatrix system = laplacian;
+    Eigen::VectorXd heatAreas(N);
+    for(unsigned i=0; i<N; i++) {
+        heatAreas[i] = areas[i]*heats[i];
+        system.coeffRef(i, i) += heatAreas[i];
+    }
+
+    // Same sparsity for a given mesh : the ordering is only computed once
+    if(!patternAnalyzed) {
+        solver.analyzePattern(system);
+        patternAnalyzed = true;
+    }
+    solver.factorize(system);
+    if(solver.info() != Eigen::Success) {
+        std::cerr << "Bone heat system factorization failed" << std::endl;
+        return false;
+    }
+
+    weights.assign(bonesCount, std::vector<float>());
+    parallelFor(bonesCount, [&](unsigned b) {
+        Eigen::VectorXd rhs = Eigen::VectorXd::Zero(N);
+        for(unsigned i=0; i<N; i++) {
+            if(closestBones[i] == b) rhs[i] = heatAreas[i];
+        }
+        Eigen::VectorXd w = solver.solve(rhs);
+        weights[b].resize(N);
+        for(unsigned i=0; i<N; i++) {
+            weights[b][i] = w[i];
+        }
+    });
+    return true;
+}
@@ -0,0 +1,51 @@
+#ifndef _SKETCHY_BONE_HEAT_SOLVER_
+#define _SKETCHY_BONE_HEAT_SOLVER_
+
+#include <utils.hpp>
+
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+
+/*
+Bone heat skin weights (Baran and Popovic, "Automatic Rigging and Animation
+of 3D Characters") : the weights of a bone are the equilibrium temperatures
+(L + M H) w = M H p, with L the cotangent Laplacian of the mesh, M the area
+of each vertex, H the heat received by each vertex from its closest bone
+and p 1 on the vertices whose closest bone is this bone, 0 elsewhere.
+The Laplacian, the areas and the sparsity analysis only depend on the mesh
+and are kept. Each set of heats needs one numeric factorization,
+then each bone is one back-substitution.
+*/
+class BoneHeatSolver {
+public:
+    BoneHeatSolver(
+        const std::vector<glm::vec3> & vertices,
+        const std::vector<glm::uvec3> & faces
+    );
+
+    /*
+    Weights of each bone (weights[bone][vertex]), the bones being solved in parallel.
+    heats : H of each vertex, closestBones : the bone heating each vertex.
+    Returns false if the system can not be factorized.
+    */
+    bool solve(
+        const std::vector<float> & heats,
+        const std::vector<unsigned> & closestBones,
+        unsigned bonesCount,
+        std::vector<std::vector<float>> & weights
+    );
+
+    inline unsigned getVerticesCount() const { return areas.size(); }
+
+private:
+    typedef Eigen::SparseMatrix<double> SparseMatrix;
+
+    // Positive semi-definite (minus) cotangent Laplacian
+    SparseMatrix laplacian;
+    Eigen::VectorXd areas;
+
+    Eigen::SimplicialLDLT<SparseMatrix> solver;
+    bool patternAnalyzed = false;
+};
+
+#endif
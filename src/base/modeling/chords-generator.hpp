@@ -11,35 +11,56 @@ public:
     const std::vector<glm::vec2> & points,
     const std::vector<std::vector<glm::vec2>> & externalAxis,
     const std::vector<std::vector<glm::vec2>> & internalAxis
-  ): points(points), externalAxis(externalAxis), internalAxis(internalAxis) {}
+  ): points(points), externalAxis(externalAxis), internalAxis(internalAxis) {
+    pointsGrid.build(points, points);
+  }
 
   inline void compute() {
     chords.clear();
-    for(auto axis : internalAxis) {
+    internalAxisChords.clear();
+    externalAxisChords.clear();
+    for(auto & axis : internalAxis) {
       // Avoid the the first and last points which are in a junction triangle
-      processAxis(axis.begin()+1, axis.begin()+axis.size()-1);
+      internalAxisChords.emplace_back(axis.size(), UINT_MAX);
+      processAxis(axis, 1, axis.size()-1, internalAxisChords.back());
     }
-    for(auto axis : externalAxis) {
+    for(auto & axis : externalAxis) {
       // Avoid the the last point which is in a junction triangle
-      processAxis(axis.begin(), axis.begin()+axis.size()-1);
+      externalAxisChords.emplace_back(axis.size(), UINT_MAX);
+      processAxis(axis, 0, axis.size()-1, externalAxisChords.back());
     }
   }
 
   inline const std::vector<Geometry::Edge> & getChords() { return chords; }
 
-  std::map<glm::vec2, Geometry::Edge> axisPointToChord;
+  /*
+  For each axis, index in the chords of the chord of each axis point
+  (UINT_MAX for the points in a junction triangle).
+  */
+  inline const std::vector<std::vector<unsigned>> & getInternalAxisChords() { return internalAxisChords; }
+  inline const std::vector<std::vector<unsigned>> & getExternalAxisChords() { return externalAxisChords; }
 
 private:
   const std::vector<glm::vec2> & points;
   const std::vector<std::vector<glm::vec2>> & externalAxis;
   const std::vector<std::vector<glm::vec2>> & internalAxis;
 
+  // Grid of the shape points
+  Geometry::UniformGrid pointsGrid;
+
   std::vector<Geometry::Edge> chords;
+  std::vector<std::vector<unsigned>> internalAxisChords;
+  std::vector<std::vector<unsigned>> externalAxisChords;
 
+  /*Chords of the axis points from begin to end (excluded).*/
   inline void processAxis(
-    std::vector<glm::vec2>::const_iterator begin,
-    std::vector<glm::vec2>::const_iterator end
+    const std::vector<glm::vec2> & axis,
+    unsigned beginIndex, unsigned endIndex,
+    std::vector<unsigned> & axisChords
   ) {
+    if(axis.size() == 0 || beginIndex >= endIndex) return;
+    auto begin = axis.begin()+beginIndex;
+    auto end = axis.begin()+endIndex;
     glm::vec2 dir;
     glm::vec2 n;
     for(auto it = begin; it!=end; it++) {
@@ -58,35 +79,43 @@ private:
       auto a = findClosestPointToSemiLine(*it, n);
       auto b = findClosestPointToSemiLine(*it, -n);
       Geometry::Edge chord(a, b);
+      axisChords[it-axis.begin()] = chords.size();
       chords.push_back(chord);
-
-      axisPointToChord.insert({*it, chord});
     }
   }
 
+  /*
+  Shape point m in the direction v from p with the smallest distance(p, m)/cos(v, m-p).
+  It is the first point reached by a growing circle tangent in p
+  to the orthogonal of v and centered on the semi-line.
+  As this value is at least distance(p, m), the grid cells are
+  visited by increasing distance to p until no closer point can be found.
+  Complexity ~ O(1) for a shape without too thin parts around p.
+  */
   inline unsigned findClosestPointToSemiLine(
     const glm::vec2 & p, const glm::vec2 & v
   ) {
-    unsigned N = points.size();
-    float minDistance = FLT_MAX;
-    float maxDot = FLT_MIN;
-    float distance = 0;
-    float dot = 0;
+    const glm::vec2 dir = glm::normalize(v);
+    float minValue = FLT_MAX;
     unsigned minDistIndex = 0;
-    float t1, t2;
     bool foundIndex = false;
-    for(unsigned i=0; i<N; i++) {
-      auto & m = points[i];
+    const auto & items = pointsGrid.getItems();
+    pointsGrid.visitAround(p, minValue, [&](int x, int y) {
+      for(unsigned k=pointsGrid.cellBegin(x, y); k<pointsGrid.cellEnd(x, y); k++) {
+        unsigned i = items[k];
+        auto & m = points[i];
 
-      distance = glm::distance(p, m);
-      dot = glm::dot(glm::normalize(v), glm::normalize(m-p));
-      if(distance*(1/dot) < minDistance*(1/maxDot) && dot>0) {
-        minDistance = distance;
-        maxDot = dot;
-        minDistIndex = i;
-        foundIndex = true;
+        float distance = glm::distance(p, m);
+        float dot = glm::dot(dir, glm::normalize(m-p));
+        if(!(dot>0)) continue;
+        float value = distance*(1/dot);
+        if(value < minValue || (value == minValue && foundIndex && i < minDistIndex)) {
+          minValue = value;
+          minDistIndex = i;
+          foundIndex = true;
+        }
       }
-    }
+    });
 
     if(!foundIndex) {
       std::cout << "Found no intersecting edge in shape for orthogonal chord" << std::endl;
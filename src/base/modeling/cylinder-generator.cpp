@@ -1,34 +1,34 @@
 #include "cylinder-generator.hpp"
 
-template <>
-struct std::less<glm::vec2>  {
-    bool operator()(const glm::vec2 & a, const glm::vec2 & b) const {
-        return a.x<b.x || (a.x==b.x && a.y<b.y);
-    }
-};
-
 void CylinderGenerator::compute(unsigned circleSampleCount) {
     float pi = M_PI;
     float stepAngle = (2.0f*pi)/circleSampleCount;
-    std::vector<std::vector<glm::vec3>> circles;
+
+    // Rotation angles of the circle samples
+    std::vector<float> cosTable(circleSampleCount);
+    std::vector<float> sinTable(circleSampleCount);
+    for(unsigned i=0; i<circleSampleCount; i++) {
+        cosTable[i] = glm::cos(-pi/2.f + stepAngle*i);
+        sinTable[i] = glm::sin(-pi/2.f + stepAngle*i);
+    }
+
+    genVertexPos.clear();
+    genVertexPos.resize(axis.size()*circleSampleCount);
+    genFaces.clear();
+    lastSectionSideA.clear();
+    lastSectionSideB.clear();
+
     for(unsigned index=0; index<axis.size(); index++) {
-        // std::cout << "Axis point " << std::endl;
         auto & axisPoint = axis[index];
-        std::vector<glm::vec3> circle;
 
-        auto chordIt = axisPointToChord.find(axisPoint);
-        if(chordIt == axisPointToChord.end()) {
+        if(index >= axisChords.size() || axisChords[index] == UINT_MAX) {
             std::cerr << "axisPoint with no chord" << std::endl;
             assert(false);
         }
-        auto chord = chordIt->second; //Geometry::getChordOnPoint(axisPoint, shape, chords);
+        auto chord = chords[axisChords[index]];
         auto chordPointA = shape[chord.a];
         auto chordPointB = shape[chord.b];
 
-        // showVec(axisPoint, "\t axisPoint = ");
-        // showVec(chordPointA, "\t chordPointA = ");
-        // showVec(chordPointB, "\t chordPointB = ");
-
         glm::vec3 rotAxis(0);
         if(index < axis.size()-1) {
             // If not the last point of the axis
@@ -49,21 +49,18 @@ void CylinderGenerator::compute(unsigned circleSampleCount) {
             0
         );
 
+        // Frame of the circle : chordPointA rotated around rotAxis by an angle a is
+        // center + cos(a)*alongChord + sin(a)*aroundAxis + (1-cos(a))*onAxis
+        const glm::vec3 d = glm::vec3(chordPointA, 0.0f) - center;
+        const glm::vec3 onAxis = glm::dot(rotAxis, d)*rotAxis;
+        const glm::vec3 alongChord = d - onAxis;
+        const glm::vec3 aroundAxis = glm::cross(rotAxis, d);
+        const glm::vec3 base = center + onAxis;
+
+        glm::vec3 * circle = &genVertexPos[index*circleSampleCount];
         for(unsigned i=0; i<circleSampleCount; i++) {
-            glm::vec3 p(chordPointA, 0.0f);
-            glm::mat4 rotMat = glm::rotate(glm::mat4(1.0), -pi/2.f + stepAngle*i, rotAxis);
-            // showVec(p, "\t p = ");
-            // showVec(center, "\t center = ");
-            // showVec(rotAxis, "\t rotAxis = ");
-            p = p - center;
-            // showVec(p, "\t p-center = ");
-            p = rotMat * glm::vec4(p, 0);
-            p = p + center;
-            circle.push_back(p);
-            // showVec(p, "\t");
-            // std::cout << std::endl;
+            circle[i] = base + cosTable[i]*alongChord + sinTable[i]*aroundAxis;
         }
-        circles.push_back(circle);
 
         if(index == axis.size()-2) {
             beforeLastChord = chord;
@@ -73,24 +70,22 @@ void CylinderGenerator::compute(unsigned circleSampleCount) {
         }
     }
 
-    for(unsigned c=0; c<circles.size(); c++) {
-        std::vector<glm::vec3> & circle = circles[c];
-        for(unsigned p=0; p<circle.size(); p++) {
-            genVertexPos.push_back(circle[p]);
-
-            if(c==circles.size()-1) {
-                if(p<circle.size()/2) {
-                    lastSectionSideA.push_back(genVertexPos.size()-1);
-                }
-                else {
-                    lastSectionSideB.push_back(genVertexPos.size()-1);
-                }
+    if(axis.size() > 0) {
+        unsigned lastCircle = (axis.size()-1)*circleSampleCount;
+        for(unsigned p=0; p<circleSampleCount; p++) {
+            if(p<circleSampleCount/2) {
+                lastSectionSideA.push_back(lastCircle+p);
+            }
+            else {
+                lastSectionSideB.push_back(lastCircle+p);
             }
         }
     }
 
+    const unsigned circleCount = axis.size();
+    genFaces.reserve(2*(circleSampleCount+1)*circleCount + circleSampleCount+1);
     unsigned nextCircleIndex = 0;
-    for(unsigned circleIndex=0; circleIndex<circles.size()-1; circleIndex++) {
+    for(unsigned circleIndex=0; circleIndex+1<circleCount; circleIndex++) {
         nextCircleIndex = circleIndex+1;
         for(unsigned circlePointIndex=0; circlePointIndex<=circleSampleCount; circlePointIndex++) {
             unsigned indexInCicle_curr_circle = circlePointIndex%circleSampleCount;
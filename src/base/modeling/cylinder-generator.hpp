@@ -12,8 +12,8 @@ public:
         const std::vector<glm::vec2> & axis,
         const std::vector<glm::vec2> & shape,
         const std::vector<Geometry::Edge> & chords,
-        const std::map<glm::vec2, Geometry::Edge> & axisPointToChord
-    ): axis(axis), shape(shape), chords(chords), axisPointToChord(axisPointToChord) {}
+        const std::vector<unsigned> & axisChords
+    ): axis(axis), shape(shape), chords(chords), axisChords(axisChords) {}
 
     void compute(unsigned circleSampleCount);
 
@@ -46,7 +46,8 @@ private:
     const std::vector<glm::vec2> & axis;
     const std::vector<glm::vec2> & shape;
     const std::vector<Geometry::Edge> & chords;
-    const std::map<glm::vec2, Geometry::Edge> & axisPointToChord;
+    // Index in chords of the chord of each axis point
+    const std::vector<unsigned> & axisChords;
 
     // Output
     std::vector<glm::vec3> genVertexPos;
@@ -1,84 +1,189 @@
 #include "cylindrical-douglas-peucker.hpp"
 
+#include <limits>
+
+void CDPErrorTable::setAxis(const std::vector<std::vector<glm::vec2>> & axis) {
+    bool same = axis.size() == axisErrors.size();
+    for(unsigned i=0; i<axis.size() && same; i++) {
+        same = axis[i] == axisErrors[i].axi;
+    }
+    if(same) return;
+
+    axisErrors.clear();
+    axisErrors.resize(axis.size());
+    for(unsigned i=0; i<axis.size(); i++) {
+        AxisErrors & errors = axisErrors[i];
+        errors.axi = axis[i];
+        errors.chordsA.resize(errors.axi.size());
+        errors.chordsB.resize(errors.axi.size());
+        for(unsigned p=0; p<errors.axi.size(); p++) {
+            const auto & chord = chordLocator.getChordOnPoint(errors.axi[p]);
+            errors.chordsA[p] = points[chord.a];
+            errors.chordsB[p] = points[chord.b];
+        }
+    }
+}
+
+const CDPErrorTable::SegmentError & CDPErrorTable::getSegmentError(
+    unsigned axisIndex,
+    unsigned start,
+    unsigned end
+) {
+    AxisErrors & errors = axisErrors[axisIndex];
+    const unsigned long long key = (unsigned long long)start*errors.axi.size() + end;
+    auto found = errors.segments.find(key);
+    if(found != errors.segments.end()) return found->second;
+
+    // The cylinder bases only depend on start and end
+    const CylinderBases bases = computeBases(errors, start, end);
+    const auto & axi = errors.axi;
+
+    SegmentError segment = {FLT_MIN, UINT_MAX, -FLT_MAX};
+    for(unsigned cur=start+1; cur<end; cur++) {
+        float error = computeError(
+            axi[start], axi[end], bases,
+            axi[cur], errors.chordsA[cur], errors.chordsB[cur]
+        );
+        if(segment.splitError <= error) {
+            segment.splitError = error;
+            segment.split = cur;
+        }
+        if(!(error <= segment.maxError)) {
+            segment.maxError = std::isnan(error) ? std::numeric_limits<float>::infinity() : error;
+        }
+    }
+    return errors.segments.emplace(key, segment).first->second;
+}
+
+CDPErrorTable::CylinderBases CDPErrorTable::computeBases(
+    const AxisErrors & errors,
+    unsigned start,
+    unsigned end
+) const {
+    const glm::vec2 & startPoint = errors.axi[start];
+    const glm::vec2 & endPoint = errors.axi[end];
+    return {
+        getPointChordProjectionOnAxiOrthogonalTo(startPoint, endPoint, errors.chordsA[start]),
+        getPointChordProjectionOnAxiOrthogonalTo(startPoint, endPoint, errors.chordsB[start]),
+        getPointChordProjectionOnAxiOrthogonalTo(endPoint, startPoint, errors.chordsA[end]),
+        getPointChordProjectionOnAxiOrthogonalTo(endPoint, startPoint, errors.chordsB[end])
+    };
+}
+
 void CDP::compute() {
+    errors.setAxis(axis);
+
     skeleton.clear();
-    for(auto ax : axis) {
+    for(unsigned i=0; i<axis.size(); i++) {
+        const auto & ax = axis[i];
         auto skel = std::vector<glm::vec2>();
 
         if(ax.size()>0) {
-            skel.push_back(*ax.begin());
-            computeSingleAxisSkeleton(
-                ax, ax.begin(), ax.begin()+ax.size()-1, skel
-            );
-            skel.push_back(*(ax.begin()+ax.size()-1));
+            skel.push_back(ax.front());
+            if(optimal) {
+                computeOptimalAxisSkeleton(i, skel);
+            }
+            else {
+                computeSingleAxisSkeleton(i, skel);
+            }
+            skel.push_back(ax.back());
 
             skeleton.push_back(skel);
         }
     }
 }
 
+/*
+Douglas-Peucker split of the whole axis, with an explicit stack of
+the segments to test instead of recursion.
+A segment is split at its point of largest error if it is above the threshold.
+The inner joints (not the axis extremities) are appended to skeleton
+in the axis order.
+*/
 void CDP::computeSingleAxisSkeleton(
-    const std::vector<glm::vec2> & axi,
-    std::vector<glm::vec2>::iterator start,
-    std::vector<glm::vec2>::iterator end,
+    unsigned axisIndex,
     std::vector<glm::vec2> & skeleton
 ){
-    if(start == end) return;
-
-    auto cur = start+1;
-    auto split = start+1;
-    bool haveSplit = false;
-    float error = 0;
-    float maxError = FLT_MIN;
-    for(;cur!=end;cur++) {
-        error = computeError(*start, *end, *cur);
-        // std::cout << "error : " << error << std::endl;
-        if(error > threshold && maxError <= error) {
-            split = cur;
-            maxError = error;
-            haveSplit = true;
-            // std::cout << "split" << std::endl;
+    const auto & axi = axis[axisIndex];
+    if(axi.size() < 3) return;
+
+    std::vector<unsigned> splits;
+    std::vector<glm::uvec2> segments;
+    segments.emplace_back(0, axi.size()-1);
+    while(segments.size() > 0) {
+        const unsigned start = segments.back().x;
+        const unsigned end = segments.back().y;
+        segments.pop_back();
+
+        const auto & error = errors.getSegmentError(axisIndex, start, end);
+        if(error.split != UINT_MAX && error.splitError > threshold) {
+            const unsigned split = error.split;
+            splits.push_back(split);
+            if(split-start > 1) segments.emplace_back(start, split);
+            if(end-split > 1) segments.emplace_back(split, end);
         }
     }
 
-    if(haveSplit) {
-        computeSingleAxisSkeleton(axi, start, split, skeleton);
-        skeleton.push_back(*split);
-        computeSingleAxisSkeleton(axi, split, end, skeleton);
-    } 
+    // Segments are disjoint, the sorted splits are in the axis order
+    std::sort(splits.begin(), splits.end());
+    for(auto split : splits) {
+        skeleton.push_back(axi[split]);
+    }
 }
 
-float CDP::computeError(
+/*
+Smallest set of joints such that no axis point of a bone has an error
+above the threshold, by dynamic programming over the error of every
+(start, end) segment of the axis.
+The inner joints are appended to skeleton in the axis order.
+Complexity ~ O(N^3) for an axis of N points the first time,
+O(N^2) once the segment errors are known.
+*/
+void CDP::computeOptimalAxisSkeleton(
+    unsigned axisIndex,
+    std::vector<glm::vec2> & skeleton
+) {
+    const auto & axi = axis[axisIndex];
+    const unsigned N = axi.size();
+    if(N < 3) return;
+
+    // bones[j] : fewest bones from the axis start to the point j
+    // previous[j] : previous joint of j in that skeleton
+    std::vector<unsigned> bones(N, UINT_MAX);
+    std::vector<unsigned> previous(N, 0);
+    bones[0] = 0;
+    for(unsigned end=1; end<N; end++) {
+        for(unsigned start=0; start<end; start++) {
+            if(bones[start] == UINT_MAX || bones[start]+1 >= bones[end]) continue;
+
+            if(errors.getSegmentError(axisIndex, start, end).maxError <= threshold) {
+                bones[end] = bones[start]+1;
+                previous[end] = start;
+            }
+        }
+    }
+
+    std::vector<unsigned> joints;
+    for(unsigned j=previous[N-1]; j>0; j=previous[j]) {
+        joints.push_back(j);
+    }
+    for(auto it=joints.rbegin(); it!=joints.rend(); it++) {
+        skeleton.push_back(axi[*it]);
+    }
+}
+
+float CDPErrorTable::computeError(
     const glm::vec2 & start,
     const glm::vec2 & end,
-    const glm::vec2 & v
-) {
-    // showVec(start, "start");
-    // showVec(end, "end");
-    // showVec(v, "v");
-    auto startChord = Geometry::getChordOnPoint(start, points, chords);
-    auto endChord = getChordOnPoint(end, points, chords);
-    // showVec(points[startChord.a], "points[startChord.a]");
-    // showVec(points[startChord.b], "points[startChord.b]");
-    // showVec(points[endChord.a], "points[endChord.a]");
-    // showVec(points[endChord.b], "points[endChord.b]");
-    glm::vec2 baseA = getPointChordProjectionOnAxiOrthogonalTo(start, end, points[startChord.a]);
-    glm::vec2 baseB = getPointChordProjectionOnAxiOrthogonalTo(start, end, points[startChord.b]);
-    glm::vec2 baseC = getPointChordProjectionOnAxiOrthogonalTo(end, start, points[endChord.a]);
-    glm::vec2 baseD = getPointChordProjectionOnAxiOrthogonalTo(end, start, points[endChord.b]);
-
-    // showVec(baseA, "baseA");
-    // showVec(baseB, "baseB");
-    // showVec(baseC, "baseC");
-    // showVec(baseD, "baseD");
-
-    const auto & vChord = getChordOnPoint(v, points, chords);
-    // showVec(points[vChord.a], "points[vChord.a],");
-    // showVec(points[vChord.b], "points[vChord.b],");
-    auto e1_dTop = Geometry::pointToSegmentDistance(points[vChord.a], baseA, baseD);
-    auto e1_dBottom = Geometry::pointToSegmentDistance(points[vChord.a], baseB, baseC);
-    auto e2_dTop = Geometry::pointToSegmentDistance(points[vChord.b], baseA, baseD);
-    auto e2_dBottom = Geometry::pointToSegmentDistance(points[vChord.b], baseB, baseC);
+    const CylinderBases & bases,
+    const glm::vec2 & v,
+    const glm::vec2 & vChordA,
+    const glm::vec2 & vChordB
+) const {
+    auto e1_dTop = Geometry::pointToSegmentDistance(vChordA, bases.a, bases.d);
+    auto e1_dBottom = Geometry::pointToSegmentDistance(vChordA, bases.b, bases.c);
+    auto e2_dTop = Geometry::pointToSegmentDistance(vChordB, bases.a, bases.d);
+    auto e2_dBottom = Geometry::pointToSegmentDistance(vChordB, bases.b, bases.c);
     float e1 = glm::min(e1_dTop, e1_dBottom);
     float e2 = glm::min(e2_dTop, e2_dBottom);
 
@@ -86,13 +191,10 @@ float CDP::computeError(
     distanceError = distanceError*distanceError;
     float cylindricalError = e1*e1 + e2*e2;
 
-    // std::cout << "cylindricalError = " << cylindricalError << std::endl;
-    // std::cout << "distanceError = " << distanceError << std::endl;
-
     return importanceCylindricalError*cylindricalError + importanceDistanceError*distanceError;
 }
 
-glm::vec2 CDP::getPointChordProjectionOnAxiOrthogonalTo(
+glm::vec2 CDPErrorTable::getPointChordProjectionOnAxiOrthogonalTo(
     const glm::vec2 & v0, const glm::vec2 & v1,
     const glm::vec2 & p
 ) {
@@ -3,22 +3,101 @@
 
 #include <utils.hpp>
 #include <map>
+#include <unordered_map>
 
 #include <geometry/geometry.hpp>
 
-class CDP {
+/*
+Errors of the bones tested by the cylindrical Douglas-Peucker, which do
+not depend on the threshold : the chord of each axis point is looked up
+once, and the errors of a (start, end) bone are computed the first time
+it is tested. Kept between CDP runs, a threshold change only reads it.
+Only valid for one shape triangulation and one set of error importances.
+*/
+class CDPErrorTable {
 public:
-    CDP(
+    CDPErrorTable(
         const std::vector<glm::vec2> & points,
-        const std::vector<std::vector<glm::vec2>> & axis,
-        const std::vector<Geometry::Edge> & chords,
-        float threshold,
+        const Geometry::ChordLocator & chordLocator,
         float importanceCylindricalError = 1.0f,
         float importanceDistanceError = 1.0f
-    ): points(points), axis(axis), chords(chords), threshold(threshold),
+    ): points(points), chordLocator(chordLocator),
     importanceCylindricalError(importanceCylindricalError),
     importanceDistanceError(importanceDistanceError) {}
 
+    struct SegmentError {
+        // Largest error of the inner points (at least FLT_MIN),
+        // and the last point reaching it (UINT_MAX if none)
+        float splitError;
+        unsigned split;
+        // Largest error of the inner points, a NaN error counting as infinite
+        float maxError;
+    };
+
+    inline bool hasImportances(float cylindrical, float distance) const {
+        return importanceCylindricalError == cylindrical && importanceDistanceError == distance;
+    }
+
+    /*Use this axis list, the stored errors are dropped if it changed.*/
+    void setAxis(const std::vector<std::vector<glm::vec2>> & axis);
+
+    const SegmentError & getSegmentError(unsigned axisIndex, unsigned start, unsigned end);
+
+private:
+    const std::vector<glm::vec2> & points;
+    const Geometry::ChordLocator & chordLocator;
+
+    float importanceCylindricalError = 1.0f;
+    float importanceDistanceError = 1.0f;
+
+    struct AxisErrors {
+        std::vector<glm::vec2> axi;
+        // Extremities of the chord of each axis point
+        std::vector<glm::vec2> chordsA;
+        std::vector<glm::vec2> chordsB;
+        // Errors of the tested segments, by start*size + end
+        std::unordered_map<unsigned long long, SegmentError> segments;
+    };
+    std::vector<AxisErrors> axisErrors;
+
+    /*
+    Projections of the start and end chords extremities
+    on the lines orthogonal to the tested segment.
+    */
+    struct CylinderBases {
+        glm::vec2 a, b, c, d;
+    };
+
+    CylinderBases computeBases(
+        const AxisErrors & errors,
+        unsigned start,
+        unsigned end
+    ) const;
+
+    float computeError(
+        const glm::vec2 & start,
+        const glm::vec2 & end,
+        const CylinderBases & bases,
+        const glm::vec2 & v,
+        const glm::vec2 & vChordA,
+        const glm::vec2 & vChordB
+    ) const;
+
+    static glm::vec2 getPointChordProjectionOnAxiOrthogonalTo(
+        const glm::vec2 & v0, const glm::vec2 & v1,
+        const glm::vec2 & p
+    );
+};
+
+class CDP {
+public:
+    CDP(
+        const std::vector<std::vector<glm::vec2>> & axis,
+        CDPErrorTable & errors,
+        float threshold,
+        bool optimal = false
+    ): axis(axis), errors(errors), threshold(threshold), optimal(optimal) {}
+
     void compute();
 
     inline std::vector<std::vector<glm::vec2>> & getSkeleton() {return skeleton;}
@@ -34,32 +113,23 @@ public:
     }
 
 private:
-    const std::vector<glm::vec2> & points;
     const std::vector<std::vector<glm::vec2>> & axis;
-    const std::vector<Geometry::Edge> & chords;
+    CDPErrorTable & errors;
     float threshold;
 
-    float importanceCylindricalError = 1.0f;
-    float importanceDistanceError = 1.0f;
+    // Minimum number of joints under the threshold instead of the Douglas-Peucker splits
+    bool optimal = false;
 
     std::vector<std::vector<glm::vec2>> skeleton;
 
     void computeSingleAxisSkeleton(
-        const std::vector<glm::vec2> & axi,
-        std::vector<glm::vec2>::iterator start,
-        std::vector<glm::vec2>::iterator end,
+        unsigned axisIndex,
         std::vector<glm::vec2> & skeleton
     );
 
-    float computeError(
-        const glm::vec2 & start,
-        const glm::vec2 & end,
-        const glm::vec2 & v
-    );
-
-    glm::vec2 getPointChordProjectionOnAxiOrthogonalTo(
-        const glm::vec2 & v0, const glm::vec2 & v1,
-        const glm::vec2 & p
+    void computeOptimalAxisSkeleton(
+        unsigned axisIndex,
+        std::vector<glm::vec2> & skeleton
     );
 
 };
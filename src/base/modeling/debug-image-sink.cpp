@@ -0,0 +1,75 @@
+#include "debug-image-sink.hpp"
+
+DebugImageSink::~DebugImageSink() {
+    if(writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopWriter = true;
+        }
+        condition.notify_all();
+        writer.join();
+    }
+}
+
+void DebugImageSink::setLevel(Level level) {
+    if(this->level == AsyncDisk && level != AsyncDisk) {
+        flush();
+    }
+    this->level = level;
+}
+
+void DebugImageSink::setPrefix(const std::string & prefix) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->prefix = prefix;
+}
+
+void DebugImageSink::add(const std::string & name, const Geometry::DrawBuilder & builder) {
+    if(!isEnabled()) return;
+
+    DebugImage image;
+    image.width = builder.getWidth();
+    image.height = builder.getHeight();
+    image.pixels.assign(
+        builder.getPixels(),
+        builder.getPixels() + image.width*image.height*3
+    );
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        image.name = prefix + name;
+        if(level == InMemory) {
+            images.push_back(std::move(image));
+            return;
+        }
+        pending.push_back(std::move(image));
+        if(!writer.joinable()) {
+            writer = std::thread(&DebugImageSink::writeImages, this);
+        }
+    }
+    condition.notify_all();
+}
+
+void DebugImageSink::flush() {
+    std::unique_lock<std::mutex> lock(mutex);
+    condition.wait(lock, [this]() { return pending.empty() && !writing; });
+}
+
+/*
+Writing thread : encodes the pending images until the sink is destroyed.
+*/
+void DebugImageSink::writeImages() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+        condition.wait(lock, [this]() { return !pending.empty() || stopWriter; });
+        if(pending.empty()) break;
+
+        DebugImage image = std::move(pending.front());
+        pending.pop_front();
+        writing = true;
+        lock.unlock();
+        Geometry::writePNG(image.name, image.width, image.height, image.pixels.data());
+        lock.lock();
+        writing = false;
+        condition.notify_all();
+    }
+}
@@ -0,0 +1,72 @@
+#ifndef _SKETCHY_DEBUG_IMAGE_SINK_
+#define _SKETCHY_DEBUG_IMAGE_SINK_
+
+#include <utils.hpp>
+#include <geometry/draw-2d.hpp>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+
+/*An image of an intermediate result of the pipeline.*/
+struct DebugImage {
+    std::string name;
+    unsigned width = 0;
+    unsigned height = 0;
+    std::vector<uint8_t> pixels; // RGB
+};
+
+/*
+Destination of the debug images of the pipeline :
+- Off : nothing is drawn
+- InMemory : images are kept in the sink (see getImages)
+- AsyncDisk : images are written as PNG files by a background thread
+The images are only drawn when isEnabled() returns true.
+Images can be added from any thread.
+*/
+class DebugImageSink {
+public:
+    enum Level { Off, InMemory, AsyncDisk };
+
+    DebugImageSink(Level level = Off): level(level) {}
+
+    /*Waits for the pending images to be written.*/
+    ~DebugImageSink();
+
+    inline bool isEnabled() const { return level != Off; }
+    inline Level getLevel() const { return level.load(); }
+    void setLevel(Level level);
+
+    /*Prepended to the names of the images added next (a directory and file prefix).*/
+    void setPrefix(const std::string & prefix);
+
+    /*Copies the image of the builder. Does nothing if the sink is Off.*/
+    void add(const std::string & name, const Geometry::DrawBuilder & builder);
+
+    /*Images added while InMemory, to read when no pipeline is running.*/
+    inline const std::vector<DebugImage> & getImages() const { return images; }
+    inline void clearImages() { images.clear(); }
+
+    /*Waits until every image added while AsyncDisk is written.*/
+    void flush();
+
+private:
+    std::atomic<Level> level;
+    std::string prefix;
+
+    std::vector<DebugImage> images;
+
+    // Images waiting to be written, and the writing thread
+    std::deque<DebugImage> pending;
+    bool writing = false;
+    bool stopWriter = false;
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable condition;
+
+    void writeImages();
+};
+
+#endif
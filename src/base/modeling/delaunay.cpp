@@ -2,6 +2,13 @@
 
 #include <CDT.h>
 
+#include <unordered_set>
+
+/*Key of the non oriented edge (a, b).*/
+static inline unsigned long long edgeKey(unsigned a, unsigned b) {
+  return ((unsigned long long)glm::min(a, b) << 32) | glm::max(a, b);
+}
+
 void ConstrainedDelaunayTriangulation2D::constrainedDelaunayWithCDT(
   const std::vector<glm::vec2> & points,
   bool constraints
@@ -34,49 +41,27 @@ void ConstrainedDelaunayTriangulation2D::constrainedDelaunayWithCDT(
   // cdt.eraseSuperTriangle();
   if(constraints) cdt.eraseOuterTriangles();
   // cdt.eraseOuterTrianglesAndHoles();
-  for(auto f : cdt.triangles) {
-    triangles.emplace_back(f.vertices[0], f.vertices[1], f.vertices[2]);
-
-    {
-      bool isNotFixed = true;
-      auto a = f.vertices[0];
-      auto b = f.vertices[1];
-      for(auto e : cdt.fixedEdges) {
-        if( (e.v1() == a || e.v2() == a) && (e.v1() == b || e.v2() == b)) {
-          isNotFixed = false;
-        }
-      }
-      if(isNotFixed) {
-        edges.emplace_back(a, b);
-      }
-    }
+  // Fixed edges and already emitted edges, keyed by their packed vertex indices
+  std::unordered_set<unsigned long long> fixedEdges;
+  fixedEdges.reserve(cdt.fixedEdges.size());
+  for(auto & e : cdt.fixedEdges) {
+    fixedEdges.insert(edgeKey(e.v1(), e.v2()));
+  }
+  std::unordered_set<unsigned long long> emittedEdges;
+  emittedEdges.reserve(cdt.triangles.size()*3/2);
 
-    {
-      bool isNotFixed = true;
-      auto a = f.vertices[1];
-      auto b = f.vertices[2];
-      for(auto e : cdt.fixedEdges) {
-        if( (e.v1() == a || e.v2() == a) && (e.v1() == b || e.v2() == b)) {
-          isNotFixed = false;
-        }
-      }
-      if(isNotFixed) {
-        edges.emplace_back(a, b);
-      }
-    }
+  triangles.reserve(cdt.triangles.size());
+  for(auto & f : cdt.triangles) {
+    triangles.emplace_back(f.vertices[0], f.vertices[1], f.vertices[2]);
 
-    {
-      bool isNotFixed = true;
-      auto a = f.vertices[2];
-      auto b = f.vertices[0];
-      for(auto e : cdt.fixedEdges) {
-        if( (e.v1() == a || e.v2() == a) && (e.v1() == b || e.v2() == b)) {
-          isNotFixed = false;
-        }
-      }
-      if(isNotFixed) {
+    // Each internal edge is shared by two triangles but is emitted once
+    for(unsigned i=0; i<3; i++) {
+      auto a = f.vertices[i];
+      auto b = f.vertices[(i+1)%3];
+      auto key = edgeKey(a, b);
+      if(fixedEdges.count(key)==0 && emittedEdges.insert(key).second) {
         edges.emplace_back(a, b);
       }
     }
   }
-}
\ No newline at end of file
+}
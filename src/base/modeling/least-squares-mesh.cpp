@@ -0,0 +1,87 @@
+#include "least-squares-mesh.hpp"
+
+#include <algorithm>
+
+LeastSquaresMesh::LeastSquaresMesh(
+    unsigned verticesCount,
+    const std::vector<glm::uvec3> & faces,
+    const std::vector<bool> & constrained
+): faces(faces), constrained(constrained) {
+    const unsigned N = verticesCount;
+
+    // Index of each vertex in its group
+    std::vector<unsigned> columns(N);
+    for(unsigned i=0; i<N; i++) {
+        if(constrained[i]) {
+            columns[i] = constrainedVertices.size();
+            constrainedVertices.push_back(i);
+        }
+        else {
+            columns[i] = freeVertices.size();
+            freeVertices.push_back(i);
+        }
+    }
+
+    std::vector<std::vector<unsigned>> neighbours(N);
+    for(auto & face : faces) {
+        const unsigned ids[3] = {face.x, face.y, face.z};
+        for(unsigned c=0; c<3; c++) {
+            neighbours[ids[c]].push_back(ids[(c+1)%3]);
+            neighbours[ids[(c+1)%3]].push_back(ids[c]);
+        }
+    }
+
+    // Row i of the uniform Laplacian : x_i minus the mean of its neighbours
+    std::vector<Eigen::Triplet<double>> freeTriplets;
+    std::vector<Eigen::Triplet<double>> constrainedTriplets;
+    for(unsigned i=0; i<N; i++) {
+        auto & adjs = neighbours[i];
+        std::sort(adjs.begin(), adjs.end());
+        adjs.erase(std::unique(adjs.begin(), adjs.end()), adjs.end());
+
+        if(constrained[i]) constrainedTriplets.emplace_back(i, columns[i], 1.0);
+        else freeTriplets.emplace_back(i, columns[i], 1.0);
+        for(unsigned j : adjs) {
+            const double w = -1.0/adjs.size();
+            if(constrained[j]) constrainedTriplets.emplace_back(i, columns[j], w);
+            else freeTriplets.emplace_back(i, columns[j], w);
+        }
+    }
+
+    freeColumns.resize(N, freeVertices.size());
+    freeColumns.setFromTriplets(freeTriplets.begin(), freeTriplets.end());
+    constrainedColumns.resize(N, constrainedVertices.size());
+    constrainedColumns.setFromTriplets(constrainedTriplets.begin(), constrainedTriplets.end());
+
+    if(freeVertices.empty()) return;
+    SparseMatrix normal = SparseMatrix(freeColumns.transpose())*freeColumns;
+    solver.compute(normal);
+    if(solver.info() != Eigen::Success) {
+        std::cerr << "Least-squares mesh factorization failed" << std::endl;
+    }
+}
+
+bool LeastSquaresMesh::hasTopology(
+    const std::vector<glm::uvec3> & faces,
+    const std::vector<bool> & constrained
+) const {
+    return this->constrained == constrained && this->faces == faces;
+}
+
+bool LeastSquaresMesh::solve(std::vector<glm::vec3> & vertices) const {
+    if(freeVertices.empty()) return true;
+    if(solver.info() != Eigen::Success) return false;
+
+    Eigen::MatrixXd fixed(constrainedVertices.size(), 3);
+    for(unsigned k=0; k<constrainedVertices.size(); k++) {
+        const glm::vec3 & p = vertices[constrainedVertices[k]];
+        fixed.row(k) << p.x, p.y, p.z;
+    }
+    Eigen::MatrixXd rhs = -(freeColumns.transpose()*(constrainedColumns*fixed));
+    Eigen::MatrixXd result = solver.solve(rhs);
+
+    for(unsigned k=0; k<freeVertices.size(); k++) {
+        vertices[freeVertices[k]] = glm::vec3(result(k, 0), result(k, 1), result(k, 2));
+    }
+    return true;
+}
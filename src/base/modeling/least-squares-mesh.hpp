@@ -0,0 +1,56 @@
+#ifndef _SKETCHY_LEAST_SQUARES_MESH_
+#define _SKETCHY_LEAST_SQUARES_MESH_
+
+#include <utils.hpp>
+
+#include <Eigen/SparseCore>
+#include <Eigen/SparseCholesky>
+
+/*
+Least-squares meshes (Sorkine and Cohen-Or) : the free vertices are placed
+so that the uniform Laplacian of the mesh is as small as possible, the
+constrained vertices keeping their positions. With L_f and L_c the columns
+of the Laplacian of the free and constrained vertices, the free positions
+solve (L_f^T L_f) x_f = -L_f^T L_c x_c.
+The matrix only depends on the faces and on which vertices are constrained :
+it is factorized once, then each solve with other constrained positions
+is a back-substitution.
+*/
+class LeastSquaresMesh {
+public:
+    LeastSquaresMesh(
+        unsigned verticesCount,
+        const std::vector<glm::uvec3> & faces,
+        const std::vector<bool> & constrained
+    );
+
+    /*True if the factorization can be used for this mesh and these constraints.*/
+    bool hasTopology(
+        const std::vector<glm::uvec3> & faces,
+        const std::vector<bool> & constrained
+    ) const;
+
+    /*
+    Replace the free vertices by their least-squares positions,
+    the constrained ones are read from vertices.
+    Returns false if the system could not be factorized.
+    */
+    bool solve(std::vector<glm::vec3> & vertices) const;
+
+private:
+    typedef Eigen::SparseMatrix<double> SparseMatrix;
+
+    std::vector<glm::uvec3> faces;
+    std::vector<bool> constrained;
+
+    std::vector<unsigned> freeVertices;
+    std::vector<unsigned> constrainedVertices;
+
+    // Laplacian columns of the free and constrained vertices
+    SparseMatrix freeColumns;
+    SparseMatrix constrainedColumns;
+
+    Eigen::SimplicialLDLT<SparseMatrix> solver;
+};
+
+#endif
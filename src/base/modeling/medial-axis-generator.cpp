@@ -7,6 +7,43 @@
 #include <jc_voronoi/jc_voronoi_clip.h>
 
 
+/*
+Walk along the axis going from the point from to the point next,
+while the points have exactly two neighbors, appending them to axis.
+Returns the last point reached (the first point with a different
+number of neighbors, or the point closing a loop).
+Points are followed by position : if several points share a position
+the first inserted one is used.
+Complexity ~ O(L log(L)) for an axis of L points.
+*/
+MedialAxisPoint * MedialAxisGenerator::followAxis(
+  MedialAxisPoint * from,
+  MedialAxisPoint * next,
+  std::vector<glm::vec2> & axis
+) {
+  axis.push_back(from->getPoint());
+  axis.push_back(next->getPoint());
+  std::set<glm::vec2> visited(axis.begin(), axis.end());
+  glm::vec2 prevStart = from->getPoint();
+  glm::vec2 start = next->getPoint();
+  MedialAxisPoint * startPoint = medialAxis.getAxisPoint(start);
+  while(startPoint->getAdjs().size()==2) {
+    // While we are on the same axis
+    const auto & adjs = startPoint->getAdjs();
+    glm::vec2 following = (adjs[0]->getPoint()==prevStart) ? adjs[1]->getPoint() : adjs[0]->getPoint();
+    prevStart = start;
+    start = following;
+    startPoint = medialAxis.getAxisPoint(start);
+
+    // To prevent eventual loops
+    if(!visited.insert(start).second) {
+      break;
+    }
+    axis.push_back(start);
+  }
+  return startPoint;
+}
+
 /*
 Return each external axis from the medial axis.
 Each returned axis start from limb extremities and 
@@ -14,44 +51,18 @@ end with a junction point (3 or more neighbors. or a limb extremity).
 */
 std::vector<std::vector<glm::vec2>> MedialAxisGenerator::extractExternalAxis() {
   std::vector<std::vector<glm::vec2>> axisList;
-  std::vector<glm::vec2> externalAxisEndPoints;
+  std::set<glm::vec2> externalAxisEndPoints;
   for(auto medialPoint : medialAxis.getPoints()) {
     if(medialPoint->getAdjs().size()==1) {
       std::vector<glm::vec2> axis;
-      axis.push_back(medialPoint->getPoint());
-      axis.push_back(medialPoint->getAdjs()[0]->getPoint());
-      auto prevStart = medialPoint->getPoint();
-      auto start = medialPoint->getAdjs()[0]->getPoint();
-      bool stop = false;
-      while(!stop && medialAxis.getAxisPoint(start)->getAdjs().size()==2) {
-        // While we are on the same axis
-        auto adjs = medialAxis.getAxisPoint(start)->getAdjs();
-        if(adjs[0]->getPoint()==prevStart) {
-          prevStart = start;
-          start = adjs[1]->getPoint();
-        }
-        else {
-          prevStart = start;
-          start = adjs[0]->getPoint();
-        }
+      followAxis(medialPoint, medialPoint->getAdjs()[0], axis);
 
-        // To prevent eventual loops
-        if(std::find(axis.begin(), axis.end(), start) != axis.end()) {
-          stop = true;
-        }
-        else {
-          axis.push_back(start);
-        }
-      }
-
-      if(std::find(
-        externalAxisEndPoints.begin(), externalAxisEndPoints.end(), axis[0]
-      ) == externalAxisEndPoints.end()) {
+      if(externalAxisEndPoints.find(axis[0]) == externalAxisEndPoints.end()) {
         // We make sure the the axis doesn't start iwth the end of another external axis
         // Other wise they are the same but in reverse order
         axisList.push_back(axis);
       }
-      externalAxisEndPoints.push_back(axis[axis.size()-1]);
+      externalAxisEndPoints.insert(axis[axis.size()-1]);
     }
   }
   return axisList;
@@ -63,46 +74,18 @@ Return each internal axis from the medial axis.
 std::vector<std::vector<glm::vec2>> MedialAxisGenerator::extractInternalAxis() {
   std::vector<std::vector<glm::vec2>> axisList;
   // list of points that are ajacent to points with 3 or more adjacent points
-  std::vector<glm::vec2> internalAxisEndPoints;
+  std::set<glm::vec2> internalAxisEndPoints;
   for(auto medialPoint : medialAxis.getPoints()) {
     if(medialPoint->getAdjs().size()>2) {
       // We start with an internal node
       for(auto adjPoint : medialPoint->getAdjs()) {
-        if(std::find(
-          internalAxisEndPoints.begin(),
-          internalAxisEndPoints.end(),
-          adjPoint->getPoint()
-        ) == internalAxisEndPoints.end()) {
+        if(internalAxisEndPoints.find(adjPoint->getPoint()) == internalAxisEndPoints.end()) {
           // If the adjacent point is not the end of a previous internal axis
           std::vector<glm::vec2> axis;
-          axis.push_back(medialPoint->getPoint());
-          axis.push_back(adjPoint->getPoint());
-          auto prevStart = medialPoint->getPoint();
-          auto start = adjPoint->getPoint();
-          bool stop = false;
-          while(!stop && medialAxis.getAxisPoint(start)->getAdjs().size()==2) {
-            // While we are on the same axis
-            auto adjs = medialAxis.getAxisPoint(start)->getAdjs();
-            if(adjs[0]->getPoint()==prevStart) {
-              prevStart = start;
-              start = adjs[1]->getPoint();
-            }
-            else {
-              prevStart = start;
-              start = adjs[0]->getPoint();
-            }
-
-            // To prevent eventual loops
-            if(std::find(axis.begin(), axis.end(), start) != axis.end()) {
-              stop = true;
-            }
-            else {
-              axis.push_back(start);
-            }
-          }
-          if(medialAxis.getAxisPoint(start)->getAdjs().size()>2) {
+          auto end = followAxis(medialPoint, adjPoint, axis);
+          if(end->getAdjs().size()>2) {
             // If it's an internal axis
-            internalAxisEndPoints.push_back(axis[axis.size()-2]);
+            internalAxisEndPoints.insert(axis[axis.size()-2]);
             axisList.push_back(axis);
           }
         }
@@ -206,39 +189,20 @@ unsigned MedialAxisGenerator::triangleInternalEdgeCount(
   std::vector<glm::uvec2> & internalEdges,
   std::vector<glm::uvec2> & externalEdges
 ) {
-  unsigned N = points.size();
   unsigned internalEdgeCount = 0;
-  bool foundXY = 0;
-  bool foundXZ = 0;
-  bool foundZY = 0;
-  for(unsigned i=0; i<N; i++) {
-    if((triangle.x == i && triangle.y == (i+1)%N) || (triangle.y == i && triangle.x == (i+1)%N)) {
+  const glm::uvec2 edges[3] = {
+    {triangle.x, triangle.y},
+    {triangle.x, triangle.z},
+    {triangle.z, triangle.y}
+  };
+  for(auto & edge : edges) {
+    if(isShapeEdge(edge.x, edge.y)) {
       internalEdgeCount += 1;
-      internalEdges.push_back({triangle.x, triangle.y});
-      foundXY = true;
+      internalEdges.push_back(edge);
     }
-
-    if((triangle.x == i && triangle.z == (i+1)%N) || (triangle.z == i && triangle.x == (i+1)%N)) {
-      internalEdgeCount += 1;
-      internalEdges.push_back({triangle.x, triangle.z});
-      foundXZ = true;
+    else {
+      externalEdges.push_back(edge);
     }
-    
-    if((triangle.z == i && triangle.y == (i+1)%N) || (triangle.y == i && triangle.z == (i+1)%N)) {
-      internalEdgeCount += 1;
-      internalEdges.push_back({triangle.z, triangle.y});
-      foundZY = true;
-    }
-  }
-
-  if(!foundXY) {
-    externalEdges.push_back({triangle.x, triangle.y});
-  }
-  if(!foundXZ) {
-    externalEdges.push_back({triangle.x, triangle.z});
-  }
-  if(!foundZY) {
-    externalEdges.push_back({triangle.z, triangle.y});
   }
   return internalEdgeCount;
 }
@@ -273,6 +237,6 @@ void MedialAxisGenerator::smoothAxis(const std::vector<glm::vec2> & axis, int si
     }
     newP = newP * ( 1.f/count );
     auto point = medialAxis.getAxisPoint(axis[i]);
-    if(point) point->setPoint(newP);
+    if(point) medialAxis.movePoint(point, newP);
   }
 }
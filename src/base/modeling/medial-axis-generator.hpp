@@ -3,6 +3,8 @@
 
 #include "medial-axis.hpp"
 
+#include <set>
+
 class MedialAxisGenerator {
 public:
   MedialAxisGenerator(
@@ -37,6 +39,15 @@ private:
   std::vector<glm::uvec3> junctionTriangles;
   std::vector<glm::uvec3> terminationTriangles;
   
+  /*
+  The shape is a closed polygon : an edge is on the shape
+  if its points are consecutive (modulo the number of points).
+  */
+  inline bool isShapeEdge(unsigned a, unsigned b) const {
+    const unsigned N = points.size();
+    return (a+1)%N == b || (b+1)%N == a;
+  }
+
   unsigned triangleInternalEdgeCount(
     const glm::uvec3 & triangle,
     std::vector<glm::uvec2> & internalEdges,
@@ -45,6 +56,12 @@ private:
 
   void smoothAxis(const std::vector<glm::vec2> & axis, int size);
 
+  MedialAxisPoint * followAxis(
+    MedialAxisPoint * from,
+    MedialAxisPoint * next,
+    std::vector<glm::vec2> & axis
+  );
+
 };
 
 #endif
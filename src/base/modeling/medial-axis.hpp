@@ -4,6 +4,7 @@
 #include <utils.hpp>
 
 #include <map>
+#include <unordered_map>
 
 #include <geometry/geometry.hpp>
 
@@ -16,6 +17,8 @@ struct std::less<glm::vec2>  {
 
 
 class MedialAxisPoint {
+  friend class MedialAxis;
+
 public:
   MedialAxisPoint(const glm::vec2 & point)
   : point(point) {}
@@ -43,29 +46,40 @@ public:
   inline const glm::vec2 & getPoint() { return point; }
   inline const std::vector<MedialAxisPoint *> & getAdjs() { return adjs; }
 
-  inline void setPoint(const glm::vec2 & p) { point=p; }
-
 private:
   glm::vec2 point;
   std::vector<MedialAxisPoint *> adjs;
+
+  // Position in MedialAxis::points
+  unsigned index = 0;
 };
 
+/*
+Graph of the medial axis points.
+Points are indexed by their position in a spatial hash
+(the key is the quantized position) so finding, inserting and removing
+a point doesn't need to scan the whole set of points.
+*/
 class MedialAxis {
 public:
   MedialAxis() {}
 
   inline void clear() {
     for(MedialAxisPoint * p : points) {
-      delete p;
+      if(p) delete p;
     }
     points.clear();
+    pointsIndex.clear();
+    removedCount = 0;
   }
 
   inline MedialAxisPoint * insertPoint(const glm::vec2 & point) {
     MedialAxisPoint * p = getAxisPoint(point);
     if(p == nullptr) {
       p = new MedialAxisPoint(point);
+      p->index = points.size();
       points.push_back(p);
+      pointsIndex.insert({hashKey(point), p});
     }
     return p;
   }
@@ -80,42 +94,102 @@ public:
   /*Remove a point from the medial axis.
   The edges containing that point are removed.*/
   inline void removePoint(const glm::vec2 & point) {
-    int index = getAxisPointIndex(point);
-    if(index >= 0) {
-      for(MedialAxisPoint * p : points) {
-        p->removeAdjIfExist(points[index]);
+    MedialAxisPoint * p = getAxisPoint(point);
+    if(p) {
+      // Edges are stored in both of their points
+      const std::vector<MedialAxisPoint *> adjs = p->adjs;
+      for(MedialAxisPoint * adj : adjs) {
+        adj->removeAdjIfExist(p);
       }
-      delete points[index];
-      points.erase(points.begin()+index);
+      removeFromIndex(p);
+      // The points vector is compacted on the next access
+      points[p->index] = nullptr;
+      removedCount += 1;
+      delete p;
     }
   }
 
+  /*Move a point, keeping the spatial index up to date.*/
+  inline void movePoint(MedialAxisPoint * p, const glm::vec2 & point) {
+    removeFromIndex(p);
+    p->point = point;
+    pointsIndex.insert({hashKey(point), p});
+  }
+
+  /*Return the point at this position
+  (the first inserted one if several points share it).*/
   inline MedialAxisPoint * getAxisPoint(const glm::vec2 & point) {
-    for(MedialAxisPoint * p : points) {
-      if(p->getPoint() == point) {
-        return p;
+    MedialAxisPoint * res = nullptr;
+    auto range = pointsIndex.equal_range(hashKey(point));
+    for(auto it=range.first; it!=range.second; it++) {
+      MedialAxisPoint * p = it->second;
+      if(p->getPoint() == point && (res == nullptr || p->index < res->index)) {
+        res = p;
       }
     }
-    return nullptr;
+    return res;
   }
 
   inline int getAxisPointIndex(const glm::vec2 & point) {
-    for(int i=0; i<points.size(); i++) {
-      MedialAxisPoint * p = points[i];
-      if(p->getPoint() == point) {
-        return i;
-      }
-    }
-    return -1;
+    MedialAxisPoint * p = getAxisPoint(point);
+    if(p == nullptr) return -1;
+    compact();
+    return p->index;
   }
 
-  inline const std::vector<MedialAxisPoint*> & getPoints() const { return points; }
+  inline const std::vector<MedialAxisPoint*> & getPoints() const {
+    compact();
+    return points;
+  }
 
   void showAsAdjMatrix();
   void showAsAdjList();
 
 private:
-  std::vector<MedialAxisPoint*> points;
+  mutable std::vector<MedialAxisPoint*> points;
+  mutable unsigned removedCount = 0;
+
+  std::unordered_multimap<unsigned long long, MedialAxisPoint*> pointsIndex;
+
+  // Size of the spatial hash cells
+  static constexpr float hashCellSize = 1e-4f;
+
+  static inline unsigned long long hashKey(const glm::vec2 & point) {
+    return
+      (((unsigned long long) quantize(point.x)) << 32) |
+      ((unsigned long long) quantize(point.y));
+  }
+
+  static inline unsigned quantize(float v) {
+    float q = glm::floor(v / hashCellSize);
+    if(!(q > float(INT_MIN) && q < float(INT_MAX))) return 0; // Out of range or NaN
+    return (unsigned) (int) q;
+  }
+
+  inline void removeFromIndex(MedialAxisPoint * p) {
+    auto range = pointsIndex.equal_range(hashKey(p->point));
+    for(auto it=range.first; it!=range.second; it++) {
+      if(it->second == p) {
+        pointsIndex.erase(it);
+        return;
+      }
+    }
+  }
+
+  /*Remove the slots of the removed points, keeping the insertion order.*/
+  inline void compact() const {
+    if(removedCount == 0) return;
+    unsigned count = 0;
+    for(unsigned i=0; i<points.size(); i++) {
+      if(points[i]) {
+        points[i]->index = count;
+        points[count] = points[i];
+        count += 1;
+      }
+    }
+    points.resize(count);
+    removedCount = 0;
+  }
 };
 
 #endif
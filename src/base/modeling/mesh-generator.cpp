@@ -2,6 +2,8 @@
 
 #include "delaunay.hpp"
 
+#include <parallel.hpp>
+
 #include <geometry/draw-2d.hpp>
 
 class LimbConnexions {
@@ -113,7 +115,7 @@ static int findConnectedStopPoint(
 
 static bool isInCylinderLastChordList(
   unsigned a, unsigned b,
-  const std::list<CylinderGenerator> & cylinders
+  const std::vector<CylinderGenerator> & cylinders
 ) {
   for(auto & cyl : cylinders) {
     auto c = cyl.getLastChord();
@@ -130,34 +132,52 @@ void MeshGenerator::compute() {
 
 // We compute the limb cylinders meshes ---------------------------------------
   
-  // cylinders.reserve(externalAxis.size());
+  cylinders.clear();
+  cylinders.reserve(externalAxis.size());
   for(unsigned i=0; i<externalAxis.size(); i++) {
-    auto axis = externalAxis[i];
+    const auto & axis = externalAxis[i];
     if(axis.size()>1) {
-      cylinders.emplace_back(axis, points, chords, axisPointToChord);
-      cylinders.back().compute(cylinderResolution);
-
-      for(auto f : cylinders.back().getFaces()) {
-        faces.push_back({
-          f.x + vertices.size(),
-          f.y + vertices.size(),
-          f.z + vertices.size()
-        });
-      }
-      cylinders.back().offset = vertices.size();
-      vertices.insert(
-        vertices.end(),
-        cylinders.back().getVertexPos().begin(),
-        cylinders.back().getVertexPos().end()
-      );
+      cylinders.emplace_back(axis, points, chords, externalAxisChords[i]);
     }
   }
 
+  // Limbs are independent
+  parallelFor(cylinders.size(), [this](unsigned c) {
+    cylinders[c].compute(cylinderResolution);
+  });
+
+  unsigned vertexCount = 0;
+  unsigned faceCount = 0;
+  std::vector<unsigned> faceOffsets(cylinders.size());
+  for(unsigned c=0; c<cylinders.size(); c++) {
+    cylinders[c].offset = vertexCount;
+    faceOffsets[c] = faceCount;
+    vertexCount += cylinders[c].getVertexPos().size();
+    faceCount += cylinders[c].getFaces().size();
+  }
+
+  // Each cylinder is copied in its slice of the mesh buffers
+  vertices.resize(vertexCount);
+  faces.resize(faceCount);
+  cylinderFacesCount = faceCount;
+  parallelFor(cylinders.size(), [&](unsigned c) {
+    const auto & cylinder = cylinders[c];
+    const unsigned offset = cylinder.offset;
+    std::copy(
+      cylinder.getVertexPos().begin(), cylinder.getVertexPos().end(),
+      vertices.begin()+offset
+    );
+    unsigned faceOffset = faceOffsets[c];
+    for(auto & f : cylinder.getFaces()) {
+      faces[faceOffset++] = {f.x + offset, f.y + offset, f.z + offset};
+    }
+  });
+
 // We find the limb last chord connexions -------------------------------------
 
   std::map<unsigned, std::pair<unsigned, bool>> stopPoints;
   for(unsigned index=0; index<cylinders.size(); index++) {
-    auto cylinder = std::next(cylinders.begin(), index);
+    auto cylinder = cylinders.begin()+index;
     stopPoints.insert({cylinder->getLastChord().a, {index, true}});
     stopPoints.insert({cylinder->getLastChord().b, {index, false}});
   }
@@ -165,7 +185,7 @@ void MeshGenerator::compute() {
   limbConnexions = new LimbConnexions();
 
   for(unsigned index=0; index<cylinders.size(); index++) {
-    auto cylinder = std::next(cylinders.begin(), index);
+    auto cylinder = cylinders.begin()+index;
     int pointA = cylinder->getLastChord().a;
     int pointB = cylinder->getLastChord().b;
 
@@ -245,23 +265,28 @@ void MeshGenerator::compute() {
     }
   }
 
+  linkingFacesCount = faces.size() - cylinderFacesCount;
+
   std::vector<unsigned> frontPoints;
   std::vector<unsigned> backPoints;
   std::vector<glm::vec2> frontPointsPos;
   std::vector<glm::vec2> backPointsPos;
 
-  cylinders.sort(
-    [](const CylinderGenerator & a, const CylinderGenerator & b) {
-      return a.getLastChord().a < b.getLastChord().a;
+  // Cylinders ordered by their last chord
+  std::vector<unsigned> order(cylinders.size());
+  for(unsigned i=0; i<order.size(); i++) order[i] = i;
+  std::stable_sort(order.begin(), order.end(),
+    [this](unsigned a, unsigned b) {
+      return cylinders[a].getLastChord().a < cylinders[b].getLastChord().a;
     }
   );
 
-  for(auto & cylinder : cylinders) {
-    std::cout << "cylinder : " << cylinder.getLastChord().a << "  " << cylinder.getLastChord().b << std::endl;
+  for(auto index : order) {
+    std::cout << "cylinder : " << cylinders[index].getLastChord().a << "  " << cylinders[index].getLastChord().b << std::endl;
   }
 
-  for(auto & cylinder : cylinders) {
-    cylinder.getLastChord().a;
+  for(auto index : order) {
+    const auto & cylinder = cylinders[index];
     unsigned pa = cylinder.getLastSectionSideAVertices().front();
     unsigned qa = cylinder.getLastSectionSideAVertices().back();
     unsigned pb = cylinder.getLastSectionSideBVertices().front();
@@ -313,7 +338,7 @@ void MeshGenerator::compute() {
       });
     }
 
-    {
+    if(debugSink) {
       Geometry::DrawBuilder builder(200, 200);
       glm::vec3 chordColor = {200, 200, 0};
       glm::vec3 shapeColor = {200, 0, 200};
@@ -321,7 +346,7 @@ void MeshGenerator::compute() {
       builder.drawTriangles(frontPointsPos, trianglesFront, chordColor);
       // builder.drawShape(true, frontPointsPos, shapeColor);
       builder.drawPoints(frontPointsPos, pointColor);
-      builder.save("debug.png");
+      debugSink->add("im-075-front-junctions.png", builder);
     }
   }
 
@@ -336,10 +361,10 @@ void MeshGenerator::compute() {
   }
 }
 
-std::vector<std::pair<std::list<CylinderGenerator>::iterator, bool>> MeshGenerator::getCylindersOnPoint(
+std::vector<std::pair<std::vector<CylinderGenerator>::iterator, bool>> MeshGenerator::getCylindersOnPoint(
   unsigned p
 ) {
-  std::vector<std::pair<std::list<CylinderGenerator>::iterator, bool>> res;
+  std::vector<std::pair<std::vector<CylinderGenerator>::iterator, bool>> res;
 
   auto pConns = limbConnexions->getBothWayConnexion(p);
   std::cout << "Connexions for " << p << std::endl;
@@ -350,7 +375,7 @@ std::vector<std::pair<std::list<CylinderGenerator>::iterator, bool>> MeshGenerat
   for(auto q : pConns) {
     auto qIt = limbConnexions->pointToCylinders.find(q);
     if(qIt != limbConnexions->pointToCylinders.end()) {
-      auto cyl = std::next(cylinders.begin(), qIt->second.first);
+      auto cyl = cylinders.begin()+qIt->second.first;
       res.push_back({
         cyl,
         qIt->second.second
@@ -514,8 +539,8 @@ static void connectSidesNotSameOrder(
 }
 
 static std::vector<glm::uvec3> connexionFaces(
-  const std::pair<std::list<CylinderGenerator>::iterator, bool> & connCyl1,
-  const std::pair<std::list<CylinderGenerator>::iterator, bool> & connCyl2,
+  const std::pair<std::vector<CylinderGenerator>::iterator, bool> & connCyl1,
+  const std::pair<std::vector<CylinderGenerator>::iterator, bool> & connCyl2,
   std::vector<glm::vec3> & vertices,
   const std::vector<glm::vec2> & points
 ) {
@@ -3,8 +3,8 @@
 
 #include <utils.hpp>
 #include "cylinder-generator.hpp"
+#include "debug-image-sink.hpp"
 
-#include <list>
 
 class LimbConnexions;
 
@@ -15,14 +15,16 @@ public:
     const std::vector<std::vector<glm::vec2>> & externalAxis,
     const std::vector<std::vector<glm::vec2>> & internalAxis,
     const std::vector<Geometry::Edge> & chords,
-    const std::map<glm::vec2, Geometry::Edge> & axisPointToChord,
-    unsigned cylinderResolution
+    const std::vector<std::vector<unsigned>> & externalAxisChords,
+    unsigned cylinderResolution,
+    DebugImageSink * debugSink = nullptr
   ): 
   points(points),
   externalAxis(externalAxis), internalAxis(internalAxis),
   chords(chords),
-  axisPointToChord(axisPointToChord),
-  cylinderResolution(cylinderResolution) {}
+  externalAxisChords(externalAxisChords),
+  cylinderResolution(cylinderResolution),
+  debugSink(debugSink) {}
 
   ~MeshGenerator();
 
@@ -30,22 +32,30 @@ public:
 
   std::vector<glm::vec3> & getVertices() { return vertices; }
   std::vector<glm::uvec3> & getFaces() { return faces; }
+  // The faces are the limb cylinders ones, then the ones linking the
+  // cylinders, then the front and back caps of the junctions
+  unsigned getCylinderFacesCount() const { return cylinderFacesCount; }
+  unsigned getLinkingFacesCount() const { return linkingFacesCount; }
 
 private:
   const std::vector<glm::vec2> & points;
   std::vector<std::vector<glm::vec2>> externalAxis;
   std::vector<std::vector<glm::vec2>> internalAxis;
   const std::vector<Geometry::Edge> & chords;
-  const std::map<glm::vec2, Geometry::Edge> & axisPointToChord;
+  // Index in chords of the chord of each external axis point
+  const std::vector<std::vector<unsigned>> & externalAxisChords;
   unsigned cylinderResolution;
+  DebugImageSink * debugSink;
 
   std::vector<glm::vec3> vertices;
   std::vector<glm::uvec3> faces;
+  unsigned cylinderFacesCount = 0;
+  unsigned linkingFacesCount = 0;
 
-  std::list<CylinderGenerator> cylinders;
+  std::vector<CylinderGenerator> cylinders;
 
   std::vector<glm::uvec3> createConnexionGrid(unsigned p, unsigned q);
-  std::vector<std::pair<std::list<CylinderGenerator>::iterator, bool>> getCylindersOnPoint(
+  std::vector<std::pair<std::vector<CylinderGenerator>::iterator, bool>> getCylindersOnPoint(
     unsigned p
   );
 
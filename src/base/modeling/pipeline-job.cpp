@@ -0,0 +1,122 @@
+#include "pipeline-job.hpp"
+
+PipelineJob::~PipelineJob() {
+    cancel();
+    joinRetired(true);
+    if(returned) {
+        delete returned;
+        returned = nullptr;
+    }
+}
+
+void PipelineJob::start(
+    const std::vector<glm::vec2> & sketchPoints,
+    const PipelineParameters & parameters
+) {
+    cancel();
+    joinRetired(false);
+
+    Job * job = new Job();
+    job->thread = std::thread([job, sketchPoints, parameters]() {
+        job->pipeline = new Pipeline(sketchPoints, parameters);
+        run(job);
+    });
+    current = job;
+}
+
+void PipelineJob::update(
+    Pipeline * pipeline,
+    const PipelineParameters & parameters
+) {
+    cancel();
+    joinRetired(false);
+
+    Job * job = new Job();
+    job->pipeline = pipeline;
+    job->isUpdate = true;
+    job->thread = std::thread([job, parameters]() {
+        job->pipeline->setParameters(parameters);
+        run(job);
+    });
+    current = job;
+}
+
+/*
+Computing thread body.
+*/
+void PipelineJob::run(Job * job) {
+    job->pipeline->setProgressCallback([job](Pipeline::Stage stage) {
+        job->stage = stage;
+        return !job->canceled;
+    });
+    job->success = job->pipeline->compute();
+    // The pipeline can outlive the job
+    job->pipeline->setProgressCallback(nullptr);
+    job->finished = true;
+}
+
+void PipelineJob::cancel() {
+    if(current) {
+        current->canceled = true;
+        retired.push_back(current);
+        current = nullptr;
+    }
+}
+
+Pipeline::Stage PipelineJob::getStage() const {
+    if(!current) return Pipeline::NotStarted;
+    return Pipeline::Stage(current->stage.load());
+}
+
+Pipeline * PipelineJob::takeResult() {
+    joinRetired(false);
+    if(!current || !current->finished) return nullptr;
+
+    current->thread.join();
+    Pipeline * result = nullptr;
+    if(current->success) {
+        result = current->pipeline;
+        current->pipeline = nullptr;
+    }
+    else {
+        keepReturned(current);
+    }
+    delete current;
+    current = nullptr;
+    return result;
+}
+
+Pipeline * PipelineJob::takeReturned() {
+    joinRetired(false);
+    Pipeline * pipeline = returned;
+    returned = nullptr;
+    return pipeline;
+}
+
+/*
+Take the pipeline of an update job, the last one replaces the previous.
+*/
+void PipelineJob::keepReturned(Job * job) {
+    if(!job->isUpdate || !job->pipeline) return;
+    if(returned) delete returned;
+    returned = job->pipeline;
+    job->pipeline = nullptr;
+}
+
+/*
+Delete the canceled jobs that are finished (all of them if wait is true).
+*/
+void PipelineJob::joinRetired(bool wait) {
+    for(auto it=retired.begin(); it!=retired.end();) {
+        Job * job = *it;
+        if(wait || job->finished) {
+            job->thread.join();
+            keepReturned(job);
+            delete job;
+            it = retired.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+}
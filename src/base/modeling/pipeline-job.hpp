@@ -0,0 +1,82 @@
+#ifndef _SKETCHY_PIPELINE_JOB_
+#define _SKETCHY_PIPELINE_JOB_
+
+#include "pipeline.hpp"
+
+#include <thread>
+#include <atomic>
+
+/*
+Runs the pipeline on a worker thread.
+Starting a new computation cancels the one in progress : it stops at
+the beginning of its next step and its result is dropped.
+The results are taken from the thread owning the job (the GL thread),
+which only has to upload them.
+*/
+class PipelineJob {
+public:
+    PipelineJob() {}
+    PipelineJob(const PipelineJob &) = delete;
+    PipelineJob & operator=(const PipelineJob &) = delete;
+
+    /*Cancels and waits for the running computations.*/
+    ~PipelineJob();
+
+    void start(const std::vector<glm::vec2> & sketchPoints, const PipelineParameters & parameters);
+
+    /*
+    Recompute a pipeline already computed with other parameters : only the
+    steps depending on the changed parameters are done again.
+    The job owns the pipeline until it is given back by takeResult, or by
+    takeReturned if the computation is canceled or fails.
+    */
+    void update(Pipeline * pipeline, const PipelineParameters & parameters);
+
+    void cancel();
+
+    inline bool isRunning() const { return current != nullptr; }
+
+    /*Step of the last started computation.*/
+    Pipeline::Stage getStage() const;
+
+    /*
+    The pipeline of the last started computation once it is successfully done,
+    or nullptr. The caller owns the returned pipeline.
+    */
+    Pipeline * takeResult();
+
+    /*
+    The pipeline of an update that is canceled or failed, once its thread is
+    done, or nullptr. Its steps not recomputed stay to recompute.
+    The caller owns the returned pipeline.
+    */
+    Pipeline * takeReturned();
+
+private:
+    struct Job {
+        std::thread thread;
+        std::atomic<bool> canceled;
+        std::atomic<bool> finished;
+        std::atomic<int> stage;
+        Pipeline * pipeline = nullptr;
+        bool success = false;
+        // The pipeline is given by update, it is returned if there is no result
+        bool isUpdate = false;
+
+        Job(): canceled(false), finished(false), stage(Pipeline::NotStarted) {}
+        ~Job() { if(pipeline) delete pipeline; }
+    };
+
+    Job * current = nullptr;
+    // Canceled jobs still running
+    std::vector<Job *> retired;
+    // Pipeline of the last update without result
+    Pipeline * returned = nullptr;
+
+    void joinRetired(bool wait);
+    void keepReturned(Job * job);
+
+    static void run(Job * job);
+};
+
+#endif
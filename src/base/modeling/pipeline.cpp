@@ -1,13 +1,462 @@
 #include "pipeline.hpp"
 
-std::vector<MeshGeometry> Pipeline::computeCylinders() {
+#include "delaunay.hpp"
+#include "medial-axis-generator.hpp"
+#include "smoothing.hpp"
+#include "chords-generator.hpp"
+#include "mesh-generator.hpp"
+#include "skining-generator.hpp"
+#include "bone-heat-solver.hpp"
+#include "least-squares-mesh.hpp"
 
+#include <geometry/draw-2d.hpp>
+
+static const glm::vec3 chordColor = {0, 200, 0};
+static const glm::vec3 axisColor = {0, 200, 200};
+static const glm::vec3 axisPointColor = {0, 20, 200};
+static const glm::vec3 shapeColor = {150, 0, 0};
+static const glm::vec3 shapePointColor = {0, 0, 220};
+static const glm::vec3 skeletonColor0 = {200, 0, 0};
+static const glm::vec3 skeletonColor1 = {0, 200, 0};
+static const glm::vec3 skeletonColor2 = {0, 0, 200};
+
+Pipeline::~Pipeline() {
+    if(skeletonGenerator) {
+        delete skeletonGenerator;
+        skeletonGenerator = nullptr;
+    }
+    if(boneHeatSolver) {
+        delete boneHeatSolver;
+        boneHeatSolver = nullptr;
+    }
+    if(leastSquaresMesh) {
+        delete leastSquaresMesh;
+        leastSquaresMesh = nullptr;
+    }
+    if(cdpErrors) {
+        delete cdpErrors;
+        cdpErrors = nullptr;
+    }
+    if(chordLocator) {
+        delete chordLocator;
+        chordLocator = nullptr;
+    }
+}
+
+const char * Pipeline::getStageName(Stage stage) {
+    switch(stage) {
+        case NotStarted: return "not started";
+        case Triangulation: return "triangulation";
+        case MedialAxis: return "medial axis";
+        case Chords: return "chords";
+        case Mesh: return "mesh";
+        case Smoothing: return "smoothing";
+        case Skeleton: return "skeleton";
+        case Skinning: return "skinning";
+        case Done: return "done";
+    }
+    return "";
+}
+
+bool Pipeline::enterStage(Stage stage) {
+    if(progressCallback && !progressCallback(stage)) {
+        canceled = true;
+    }
+    return !canceled;
+}
+
+bool Pipeline::setParameters(const PipelineParameters & parameters) {
+    const PipelineParameters & old = this->parameters;
+    const unsigned previousDirtyStages = dirtyStages;
+    dirtyStages = 0;
+    if(parameters.subSampling != old.subSampling) {
+        invalidate(Triangulation);
+    }
+    if(parameters.pruningThreshold != old.pruningThreshold
+    || parameters.smoothMaskSize != old.smoothMaskSize) {
+        invalidate(MedialAxis);
+    }
+    if(parameters.cylinderSampling != old.cylinderSampling) {
+        invalidate(Mesh);
+    }
+    if(parameters.junctionSmoothing != old.junctionSmoothing
+    || parameters.junctionRings != old.junctionRings) {
+        invalidate(Smoothing);
+    }
+    if(parameters.cdpThreshold != old.cdpThreshold
+    || parameters.cdpCylindricalImp != old.cdpCylindricalImp
+    || parameters.cdpDistanceImp != old.cdpDistanceImp
+    || parameters.cdpOptimal != old.cdpOptimal) {
+        invalidate(Skeleton);
+    }
+    if(parameters.skinVisibility != old.skinVisibility
+    || parameters.skinHeat != old.skinHeat) {
+        invalidate(Skinning);
+    }
+    this->parameters = parameters;
+    const bool changed = dirtyStages != 0;
+    dirtyStages |= previousDirtyStages;
+    return changed;
+}
+
+/*
+Mark a step, and the steps using its results, as to recompute.
+The skeleton only uses the axis and the triangulation chords,
+so the mesh and the skeleton do not depend on each other.
+*/
+void Pipeline::invalidate(Stage stage) {
+    dirtyStages |= 1u << stage;
+    switch(stage) {
+        case Triangulation: invalidate(MedialAxis); break;
+        case MedialAxis: invalidate(Chords); invalidate(Skeleton); break;
+        case Chords: invalidate(Mesh); break;
+        case Mesh: invalidate(Smoothing); break;
+        case Smoothing: invalidate(Skinning); break;
+        case Skeleton: invalidate(Skinning); break;
+        default: break;
+    }
+}
+
+bool Pipeline::compute() {
+    canceled = false;
+    static const Stage stages[] = {
+        Triangulation, MedialAxis, Chords, Mesh, Smoothing, Skeleton, Skinning
+    };
+    for(Stage stage : stages) {
+        if(!isDirty(stage)) continue;
+        if(!enterStage(stage)) return false;
+
+        bool success = true;
+        switch(stage) {
+            case Triangulation: success = computeTriangulation(); break;
+            case MedialAxis: success = computeMedialAxis(); break;
+            case Chords: computeChords(); break;
+            case Mesh: computeMesh(); break;
+            case Smoothing: computeSmoothing(); break;
+            case Skeleton: computeSkeleton(); break;
+            case Skinning: computeSkinning(); break;
+            default: break;
+        }
+        if(!success) return false;
+        dirtyStages &= ~(1u << stage);
+    }
+
+    enterStage(Done);
+    return true;
+}
+
+bool Pipeline::updateSkeleton(unsigned timeBudget) {
+    const unsigned skeletonStages = (1u << Skeleton) | (1u << Skinning);
+    if(!skeletonGenerator || (dirtyStages & ~skeletonStages) != 0) return false;
+    if(dirtyStages == 0) return true;
+
+    // The Douglas-Peucker errors are kept between the calls : a skeleton
+    // time measured while filling a new table says nothing about the next
+    // ones, the skeleton is then tried anyway to measure it again
+    const bool skeletonEstimated = isDirty(Skeleton) && !skeletonTimeCold;
+    const long long estimate = (skeletonEstimated ? skeletonTime : 0) + skinningTime;
+    if(estimate > timeBudget) return false;
+
+    if(isDirty(Skeleton)) computeSkeleton();
+    computeSkinning();
+    dirtyStages &= ~skeletonStages;
+    return true;
+}
+
+/*
+Delaunay constrained triangulation.
+Returns false if the shape has no chord.
+*/
+bool Pipeline::computeTriangulation() {
+    shape = Shape(parameters.subSampling, shape.getFullPoints());
+
+    if(debugImagesEnabled()) {
+        Geometry::DrawBuilder builder(parameters.debugImageWidth, parameters.debugImageHeight);
+        builder.drawShape(true, shape.getFullPoints(), shapeColor);
+        builder.drawPoints(shape.getFullPoints(), shapePointColor);
+        parameters.debugSink->add("im-000-shape.png", builder);
+    }
+
+    ConstrainedDelaunayTriangulation2D d(shape.getSubSampledPoints());
+    trianglesSub = d.getTriangles();
+    triangles = shape.convertToFullTriangleSet(trianglesSub);
+    chords = shape.convertToFullEdgeSet(d.getEdges());
+    // The Douglas-Peucker errors use the chords
+    if(cdpErrors) delete cdpErrors;
+    cdpErrors = nullptr;
+    if(chordLocator) delete chordLocator;
+    chordLocator = new Geometry::ChordLocator(shape.getFullPoints(), chords);
+    if(debugImagesEnabled()) {
+        Geometry::DrawBuilder builder(parameters.debugImageWidth, parameters.debugImageHeight);
+        builder.drawTriangles(shape.getFullPoints(), triangles, chordColor);
+        builder.drawShape(true, shape.getFullPoints(), shapeColor);
+        builder.drawPoints(shape.getFullPoints(), shapePointColor);
+        parameters.debugSink->add("im-010-delaunay-triangulation.png", builder);
+    }
+
+    if(chordLocator->isEmpty()) {
+        std::cout << "No chord !!!!! Hint : Draw a bigger shape or reduce the sub sampling" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+The raw medial axis, then pruned, then smoothed, and its external and internal axis.
+Returns false if no axis is left.
+*/
+bool Pipeline::computeMedialAxis() {
+    MedialAxisGenerator medial(shape.getSubSampledPoints(), trianglesSub);
+    medial.computeMidPoints();
+    for(unsigned i=0; i<3; i++) {
+        if(i==1) {
+            smoothing s;
+            s.insignificantBranchesRemoval(
+                medial, parameters.pruningThreshold, shape.getSubSampledPoints()
+            );
+        }
+        if(i==2) {
+            medial.smooth(parameters.smoothMaskSize);
+        }
+        if(!debugImagesEnabled()) continue;
+
+        auto & axis = medial.getMedialAxis();
+        std::vector<std::pair<glm::vec2, glm::vec2>> segments;
+        for(auto ax : axis.getPoints()) {
+            for(auto s : ax->getAdjs()) {
+                segments.emplace_back(ax->getPoint(), s->getPoint());
+            }
+        }
+        std::vector<glm::vec2> pointsSeg;
+        for(auto seg : segments) {
+            pointsSeg.push_back(seg.first);
+            pointsSeg.push_back(seg.second);
+        }
+        Geometry::DrawBuilder builder(parameters.debugImageWidth, parameters.debugImageHeight);
+        builder.addExtraPoints(shape.getFullPoints());
+        builder.addExtraPoints(pointsSeg);
+        builder.drawSegments(segments, axisColor);
+        builder.drawPoints(pointsSeg, axisPointColor);
+        builder.drawShape(true, shape.getFullPoints(), shapeColor);
+        builder.drawPoints(shape.getFullPoints(), shapePointColor);
+        if(i==0) {
+            parameters.debugSink->add("im-020-raw-medial-axis.png", builder);
+            builder.drawTriangles(shape.getFullPoints(), triangles, chordColor);
+            parameters.debugSink->add("im-020-raw-medial-axis-with-triangles.png", builder);
+        }
+        if(i==1) parameters.debugSink->add("im-030-pruned-medial-axis.png", builder);
+        if(i==2) parameters.debugSink->add("im-040-pruned-smoothed-medial-axis.png", builder);
+    }
+
+    // External and internal axis of the medial axis tree
+    externalAxis = medial.extractExternalAxis();
+    internalAxis = medial.extractInternalAxis();
+    if(debugImagesEnabled()) {
+        saveShapeImage("im-050-external-medial-axis.png", externalAxis);
+        saveShapeImage("im-060-internal-medial-axis.png", internalAxis);
+    }
+
+    if(externalAxis.size()==0 && internalAxis.size()==0) {
+        std::cout << "No axis !!!!! Hint : Reduce the prunning threshold" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*Chords orthogonal to the axis*/
+void Pipeline::computeChords() {
+    ChordsGenerator chordsGen(
+        shape.getFullPoints(),
+        externalAxis, internalAxis
+    );
+    chordsGen.compute();
+    axisChords = chordsGen.getChords();
+    externalAxisChords = chordsGen.getExternalAxisChords();
+    if(debugImagesEnabled()) {
+        Geometry::DrawBuilder builder(parameters.debugImageWidth, parameters.debugImageHeight);
+        builder.setExtraPoints(shape.getFullPoints());
+        builder.drawEdges(shape.getFullPoints(), axisChords, chordColor);
+        for(auto & ax : externalAxis) {
+            builder.drawShape(false, ax, axisColor);
+            builder.drawPoints(ax, axisPointColor);
+        }
+        for(auto & ax : internalAxis) {
+            builder.drawShape(false, ax, axisColor);
+            builder.drawPoints(ax, axisPointColor);
+        }
+        builder.drawShape(true, shape.getFullPoints(), shapeColor);
+        builder.drawPoints(shape.getFullPoints(), shapePointColor);
+        parameters.debugSink->add("im-070-chords.png", builder);
+    }
 }
 
-MeshGeometry Pipeline::computeMeshFromCylinders(std::vector<MeshGeometry> & cylinders) {
+/*Mesh vertices and faces*/
+void Pipeline::computeMesh() {
+    MeshGenerator meshGen(
+        shape.getFullPoints(),
+        externalAxis, internalAxis,
+        axisChords, externalAxisChords, parameters.cylinderSampling,
+        debugImagesEnabled() ? parameters.debugSink : nullptr
+    );
+    meshGen.compute();
+    meshVertices = meshGen.getVertices();
+    faces = meshGen.getFaces();
+    cylinderFacesCount = meshGen.getCylinderFacesCount();
+    linkingFacesCount = meshGen.getLinkingFacesCount();
+    std::cout << "Vertices : " << meshVertices.size() << std::endl;
+    std::cout << "Faces : " << faces.size() << std::endl;
+}
+
+/*
+Vertices of the faces linking the cylinders (after the cylinder faces) and the
+ones up to rings edges from them are free, the other ones are constrained.
+*/
+static std::vector<bool> junctionConstraints(
+    unsigned verticesCount,
+    const std::vector<glm::uvec3> & faces,
+    unsigned cylinderFacesCount,
+    unsigned rings
+) {
+    std::vector<bool> constrained(verticesCount, true);
+    for(unsigned f=cylinderFacesCount; f<faces.size(); f++) {
+        constrained[faces[f].x] = false;
+        constrained[faces[f].y] = false;
+        constrained[faces[f].z] = false;
+    }
+    for(unsigned r=0; r<rings; r++) {
+        std::vector<bool> next = constrained;
+        for(auto & face : faces) {
+            if(!constrained[face.x] || !constrained[face.y] || !constrained[face.z]) {
+                next[face.x] = false;
+                next[face.y] = false;
+                next[face.z] = false;
+            }
+        }
+        constrained.swap(next);
+    }
+    return constrained;
+}
+
+/*
+Least-squares meshes smoothing of the junctions. The flat caps closing the
+junctions have no inner vertices and are left out of the Laplacian, their
+long edges would pull the limbs towards the middle of the shape.
+The factorization is kept as long as the mesh has the same faces, so that
+a new mesh with the same topology only costs a back-substitution.
+*/
+void Pipeline::computeSmoothing() {
+    vertices = meshVertices;
+    // The bone heat Laplacian depends on the vertices positions
+    if(boneHeatSolver) delete boneHeatSolver;
+    boneHeatSolver = nullptr;
+    if(!parameters.junctionSmoothing) return;
+
+    std::vector<glm::uvec3> smoothedFaces(faces.begin(), faces.begin()+cylinderFacesCount+linkingFacesCount);
+    auto constrained = junctionConstraints(
+        vertices.size(), smoothedFaces, cylinderFacesCount, parameters.junctionRings);
+    if(leastSquaresMesh && !leastSquaresMesh->hasTopology(smoothedFaces, constrained)) {
+        delete leastSquaresMesh;
+        leastSquaresMesh = nullptr;
+    }
+    if(!leastSquaresMesh) {
+        leastSquaresMesh = new LeastSquaresMesh(vertices.size(), smoothedFaces, constrained);
+    }
+    if(!leastSquaresMesh->solve(vertices)) {
+        vertices = meshVertices;
+    }
+}
+
+/*Full skeleton*/
+void Pipeline::computeSkeleton() {
+    const long long start = getTimeMillis();
+    if(cdpErrors && !cdpErrors->hasImportances(parameters.cdpCylindricalImp, parameters.cdpDistanceImp)) {
+        delete cdpErrors;
+        cdpErrors = nullptr;
+    }
+    skeletonTimeCold = !cdpErrors;
+    if(!cdpErrors) {
+        cdpErrors = new CDPErrorTable(
+            shape.getFullPoints(), *chordLocator,
+            parameters.cdpCylindricalImp, parameters.cdpDistanceImp);
+    }
+
+    if(skeletonGenerator) delete skeletonGenerator;
+    skeletonGenerator = new SkeletonGenerator(
+        externalAxis, internalAxis, *cdpErrors,
+        parameters.cdpThreshold, parameters.cdpOptimal);
+    skeletonGenerator->compute();
+    skeletonTime = getTimeMillis()-start;
 
+    if(!debugImagesEnabled()) return;
+
+    Rigging & rigging = skeletonGenerator->getRigging();
+    std::vector<std::pair<glm::vec2, glm::vec2>> bones2D;
+    std::vector<glm::vec2> bonesPoints;
+    for(auto & bone : rigging.getBones()) {
+        bones2D.push_back({
+            glm::vec2(bone.getA().getPoint()),
+            glm::vec2(bone.getB().getPoint())
+        });
+        bonesPoints.push_back(glm::vec2(bone.getA().getPoint()));
+        bonesPoints.push_back(glm::vec2(bone.getB().getPoint()));
+    }
+    {
+        Geometry::DrawBuilder builder(parameters.debugImageWidth, parameters.debugImageHeight);
+        builder.setExtraPoints(shape.getFullPoints());
+        builder.addExtraPoints(bonesPoints);
+        builder.drawSegments(bones2D, skeletonColor0);
+        builder.drawShape(true, shape.getFullPoints(), shapeColor);
+        builder.drawPoints(shape.getFullPoints(), shapePointColor);
+        parameters.debugSink->add("im-080-skeleton.png", builder);
+    }
+    {
+        Geometry::DrawBuilder builder(parameters.debugImageWidth, parameters.debugImageHeight);
+        builder.setExtraPoints(shape.getFullPoints());
+        for(auto & ax : skeletonGenerator->getExternalAxisSkeleton()) {
+            builder.drawShape(false, ax, skeletonColor0);
+            builder.drawPoints(ax, axisPointColor);
+        }
+        for(auto & ax : skeletonGenerator->getInternalAxisSkeleton()) {
+            builder.drawShape(false, ax, skeletonColor1);
+            builder.drawPoints(ax, axisPointColor);
+        }
+        for(auto & ax : skeletonGenerator->getJunctionAxisSkeleton()) {
+            builder.drawShape(false, ax, skeletonColor2);
+            builder.drawPoints(ax, axisPointColor);
+        }
+        builder.drawShape(true, shape.getFullPoints(), shapeColor);
+        builder.drawPoints(shape.getFullPoints(), shapePointColor);
+        parameters.debugSink->add("im-090-skeleton-details.png", builder);
+    }
 }
 
-Rigging Pipeline::computeSkeleton(MeshGeometry & mesh) {
+/*Skinning of the mesh vertices on the skeleton bones*/
+void Pipeline::computeSkinning() {
+    const long long start = getTimeMillis();
+    Rigging & rigging = skeletonGenerator->getRigging();
+    if(parameters.skinHeat && !boneHeatSolver) {
+        boneHeatSolver = new BoneHeatSolver(vertices, faces);
+    }
+    SkiningGenerator skinGen(
+        rigging, vertices, faces, parameters.skinVisibility,
+        parameters.skinHeat ? boneHeatSolver : nullptr
+    );
+    skinGen.compute();
+    skinningTime = getTimeMillis()-start;
+    std::cout << "Bones : " << rigging.getBones().size() << std::endl;
+}
 
+void Pipeline::saveShapeImage(
+    const char * filename,
+    const std::vector<std::vector<glm::vec2>> & axisList
+) {
+    Geometry::DrawBuilder builder(parameters.debugImageWidth, parameters.debugImageHeight);
+    builder.setExtraPoints(shape.getFullPoints());
+    for(auto & ax : axisList) {
+        builder.drawShape(false, ax, axisColor);
+        builder.drawPoints(ax, axisPointColor);
+    }
+    builder.drawShape(true, shape.getFullPoints(), shapeColor);
+    builder.drawPoints(shape.getFullPoints(), shapePointColor);
+    parameters.debugSink->add(filename, builder);
 }
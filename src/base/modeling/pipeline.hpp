@@ -2,24 +2,192 @@
 #define _SKETCHY_PIPELINE_
 
 #include <utils.hpp>
-#include <mesh-geometry.hpp>
+#include <geometry/geometry.hpp>
+#include "shape.hpp"
+#include "medial-axis.hpp"
+#include "skeleton-generator.hpp"
 #include "rigging.hpp"
+#include "debug-image-sink.hpp"
 
+#include <functional>
+
+class BoneHeatSolver;
+class LeastSquaresMesh;
+
+/*
+Parameters of the sketch to rigged mesh pipeline.
+Default values are the ones of the interface sliders.
+*/
+struct PipelineParameters {
+    unsigned subSampling = 20;
+
+    float pruningThreshold = 0.5f;
+    int smoothMaskSize = 2;
+
+    unsigned cylinderSampling = 20;
+    // Least-squares meshes smoothing of the faces linking the cylinders and
+    // of the cylinder vertices up to junctionRings edges from them
+    bool junctionSmoothing = false;
+    unsigned junctionRings = 2;
+
+    float cdpThreshold = 0.3f;
+    float cdpCylindricalImp = 1.0f;
+    float cdpDistanceImp = 1.0f;
+    // Fewest joints under the threshold instead of the Douglas-Peucker splits
+    bool cdpOptimal = false;
+
+    // Vertices bound to the closest bone they see without crossing the mesh
+    bool skinVisibility = false;
+    // Smooth bone heat weights instead of the closest bone only
+    bool skinHeat = false;
+
+    // Images of each step results, none if null or Off
+    DebugImageSink * debugSink = nullptr;
+    unsigned debugImageWidth = 300;
+    unsigned debugImageHeight = 300;
+};
+
+/*
+The whole modeling pipeline, from the 2D shape to the skinned mesh :
+triangulation, medial axis, chords, mesh, junctions smoothing,
+skeleton and skinning.
+The result of each step is kept, so that changing some parameters
+only recomputes the steps depending on them (see setParameters).
+Does not need any OpenGL context.
+*/
 class Pipeline {
 public:
+    enum Stage {
+        NotStarted, Triangulation, MedialAxis, Chords, Mesh, Smoothing, Skeleton, Skinning, Done
+    };
+    static const char * getStageName(Stage stage);
+
     Pipeline(
-        std::vector<glm::vec2> & sketchPoints
-    ): sketchPoints(sketchPoints) {}
+        const std::vector<glm::vec2> & sketchPoints,
+        const PipelineParameters & parameters
+    ): shape(parameters.subSampling, sketchPoints), parameters(parameters) {
+        invalidate(Triangulation);
+    }
+
+    ~Pipeline();
+
+    // Owns the results of its steps, it can not be copied
+    Pipeline(const Pipeline &) = delete;
+    Pipeline & operator=(const Pipeline &) = delete;
+
+    /*
+    Run the steps that are not up to date (all of them the first time).
+    Returns false if the shape gives no chords or no medial axis,
+    or if the computation is canceled.
+    */
+    bool compute();
+
+    /*
+    Change the parameters and mark the steps depending on the changed ones
+    as to recompute by the next compute(). Returns true if there is any,
+    the steps left to recompute by a canceled or failed compute() aside.
+    */
+    bool setParameters(const PipelineParameters & parameters);
 
-    std::vector<MeshGeometry> computeCylinders();
+    /*
+    Recompute the skeleton and the skinning synchronously, if they are the
+    only steps to redo (after a Douglas-Peucker parameter change).
+    The cost is estimated from the last durations of these steps (the
+    skeleton one only once the Douglas-Peucker errors table is filled) :
+    if it is more than timeBudget milliseconds, nothing is done and they
+    stay to recompute. Once started, the result is kept even if it ends late.
+    Returns true if the skeleton and the skinning are updated.
+    */
+    bool updateSkeleton(unsigned timeBudget);
+    inline const PipelineParameters & getParameters() const { return parameters; }
 
-    MeshGeometry computeMeshFromCylinders(std::vector<MeshGeometry> & cylinders);
+    /*
+    Called (on the computing thread) when each step starts.
+    Returning false cancels the computation.
+    */
+    inline void setProgressCallback(const std::function<bool(Stage)> & callback) {
+        progressCallback = callback;
+    }
+    inline bool isCanceled() const { return canceled; }
 
-    Rigging computeSkeleton(MeshGeometry & mesh);
+    inline const Shape & getShape() const { return shape; }
+
+    inline const std::vector<std::vector<glm::vec2>> & getExternalAxis() const { return externalAxis; }
+    inline const std::vector<std::vector<glm::vec2>> & getInternalAxis() const { return internalAxis; }
+
+    inline const std::vector<glm::vec3> & getVertices() const { return vertices; }
+    inline const std::vector<glm::uvec3> & getFaces() const { return faces; }
+
+    inline SkeletonGenerator & getSkeletonGenerator() { return *skeletonGenerator; }
+    inline Rigging & getRigging() { return skeletonGenerator->getRigging(); }
 
 private:
-    std::vector<glm::vec2> & sketchPoints;
+    Shape shape;
+    PipelineParameters parameters;
+
+    // Triangulation of the sub sampled shape
+    std::vector<glm::uvec3> trianglesSub;
+    // Triangulation and chords with full shape indices
+    std::vector<glm::uvec3> triangles;
+    std::vector<Geometry::Edge> chords;
+    // Closest chord queries, shared by the skeleton steps
+    Geometry::ChordLocator * chordLocator = nullptr;
+
+    std::vector<std::vector<glm::vec2>> externalAxis;
+    std::vector<std::vector<glm::vec2>> internalAxis;
+
+    // Chords orthogonal to the axis
+    std::vector<Geometry::Edge> axisChords;
+    // Index in axisChords of the chord of each external axis point
+    std::vector<std::vector<unsigned>> externalAxisChords;
+
+    // Mesh before and after the junctions smoothing
+    std::vector<glm::vec3> meshVertices;
+    std::vector<glm::vec3> vertices;
+    std::vector<glm::uvec3> faces;
+    // The faces of the cylinders, then of the links between them, then the caps
+    unsigned cylinderFacesCount = 0;
+    unsigned linkingFacesCount = 0;
+    // Factorized least-squares system, kept while the mesh topology and constraints are unchanged
+    LeastSquaresMesh * leastSquaresMesh = nullptr;
+    // Laplacian of the mesh for the bone heat skinning, kept while the mesh is unchanged
+    BoneHeatSolver * boneHeatSolver = nullptr;
+
+    // Douglas-Peucker errors of the axis, kept while only its parameters change
+    CDPErrorTable * cdpErrors = nullptr;
+    SkeletonGenerator * skeletonGenerator = nullptr;
+
+    // One bit per step to recompute
+    unsigned dirtyStages = 0;
+    // Last durations of the skeleton and skinning steps, in milliseconds
+    long long skeletonTime = 0;
+    long long skinningTime = 0;
+    // The last skeleton filled a new Douglas-Peucker errors table
+    bool skeletonTimeCold = true;
+
+    std::function<bool(Stage)> progressCallback;
+    bool canceled = false;
+
+    inline bool isDirty(Stage stage) const { return dirtyStages & (1u << stage); }
+    void invalidate(Stage stage);
+    bool enterStage(Stage stage);
+
+    bool computeTriangulation();
+    bool computeMedialAxis();
+    void computeChords();
+    void computeMesh();
+    void computeSmoothing();
+    void computeSkeleton();
+    void computeSkinning();
+
+    inline bool debugImagesEnabled() const {
+        return parameters.debugSink && parameters.debugSink->isEnabled();
+    }
 
+    void saveShapeImage(
+        const char * filename,
+        const std::vector<std::vector<glm::vec2>> & axisList
+    );
 };
 
 #endif
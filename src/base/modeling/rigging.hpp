@@ -5,24 +5,65 @@
 #include "skeleton.hpp"
 
 /*
-The skinning of vertices for one bone.
+The skinning of the mesh vertices : each vertex has up to
+influencesCount (bone index, weight) pairs, stored in two flat arrays.
+Unused influences have a zero weight.
 */
-class SkinningGroup {
+class SkinWeights {
 public:
-    SkinningGroup(unsigned verticesCount) {
-        for(unsigned i=0; i<verticesCount; i++) {
-            vertexSkinWeights.insert({i, 0.0f});
+    static const unsigned influencesCount = 4;
+
+    inline void init(unsigned verticesCount) {
+        boneIndices.assign(verticesCount*influencesCount, 0);
+        weights.assign(verticesCount*influencesCount, 0.0f);
+    }
+
+    /*
+    Set the weight of the bone on the vertex. When all the influences of the
+    vertex are used, the bone replaces the smallest one if it weights more.
+    */
+    inline void setWeight(unsigned vertex, unsigned bone, float weight) {
+        unsigned * vertexBones = &boneIndices[vertex*influencesCount];
+        float * vertexWeights = &weights[vertex*influencesCount];
+        unsigned smallest = 0;
+        for(unsigned i=0; i<influencesCount; i++) {
+            if(vertexWeights[i] != 0.0f && vertexBones[i] == bone) {
+                vertexWeights[i] = weight;
+                return;
+            }
+            if(vertexWeights[i] < vertexWeights[smallest]) smallest = i;
+        }
+        if(weight > vertexWeights[smallest]) {
+            vertexBones[smallest] = bone;
+            vertexWeights[smallest] = weight;
         }
     }
 
-    inline void setSkinWeight(unsigned vertexIndice, float weight) {
-        vertexSkinWeights[vertexIndice] = weight;
+    /*Scale the weights of the vertex so that they sum to 1.*/
+    inline void normalize(unsigned vertex) {
+        float * vertexWeights = &weights[vertex*influencesCount];
+        float sum = 0.0f;
+        for(unsigned i=0; i<influencesCount; i++) sum += vertexWeights[i];
+        if(sum <= 0.0f) return;
+        for(unsigned i=0; i<influencesCount; i++) vertexWeights[i] /= sum;
     }
 
-    inline const std::map<unsigned, float> & getVertexSkinWeights() const { return vertexSkinWeights; }
+    inline float getWeight(unsigned vertex, unsigned bone) const {
+        for(unsigned i=vertex*influencesCount; i<(vertex+1)*influencesCount; i++) {
+            if(weights[i] != 0.0f && boneIndices[i] == bone) return weights[i];
+        }
+        return 0.0f;
+    }
+
+    inline unsigned getVerticesCount() const { return weights.size()/influencesCount; }
+
+    /*influencesCount values per vertex*/
+    inline const std::vector<unsigned> & getBoneIndices() const { return boneIndices; }
+    inline const std::vector<float> & getWeights() const { return weights; }
 
 private:
-    std::map<unsigned, float> vertexSkinWeights;
+    std::vector<unsigned> boneIndices;
+    std::vector<float> weights;
 };
 
 class Rigging {
@@ -92,9 +133,7 @@ public:
     inline void initSkinning(
         unsigned verticesCount
     ) {
-        auto bonesCount = bones.size();
-        bonesSkins.resize(bonesCount, SkinningGroup(verticesCount));
-        this->verticesCount = verticesCount;
+        skinWeights.init(verticesCount);
     }
 
     inline void setBoneSkinning(
@@ -102,21 +141,20 @@ public:
         const std::vector<float> & vertexSkinningWeights
     ) {
         unsigned index = getBoneIndexByJointsId(jointAId, jointBId);
-        for(unsigned i=0; i<verticesCount; i++) {
-            bonesSkins[index].setSkinWeight(i, vertexSkinningWeights[i]);
+        for(unsigned i=0; i<skinWeights.getVerticesCount(); i++) {
+            skinWeights.setWeight(i, index, vertexSkinningWeights[i]);
         }
     }
 
     inline const std::vector<SkeletonBone> & getBones() const { return bones; }
     inline const std::vector<SkeletonJoint> & getJoints() const { return joints; }
-    inline std::vector<SkinningGroup> & getBonesSkins() { return bonesSkins; }
+    inline SkinWeights & getSkinWeights() { return skinWeights; }
+    inline const SkinWeights & getSkinWeights() const { return skinWeights; }
 
 private:
     std::vector<SkeletonJoint> joints;
     std::vector<SkeletonBone> bones;
-    std::vector<SkinningGroup> bonesSkins;
-
-    unsigned verticesCount;
+    SkinWeights skinWeights;
 
     unsigned lastIDJoint = 0;
     unsigned lastIDBone = 0;
@@ -62,4 +62,24 @@ private:
 	unsigned subSampling;
 };
 
+/*
+Read the points of a shape file as written by Drawing::saveShape :
+the number of points followed by the coordinates of each point.
+Returns false if the file can't be read.
+*/
+inline bool readShapeFile(const std::string & filename, std::vector<glm::vec2> & points) {
+	std::ifstream in(filename);
+	if(!in) return false;
+
+	int count = 0;
+	in >> count;
+	points.clear();
+	points.reserve(count > 0 ? count : 0);
+	double xPos, yPos;
+	for(int i=0; i<count && (in >> xPos >> yPos); i++) {
+		points.emplace_back(xPos, yPos);
+	}
+	return points.size() > 0;
+}
+
 #endif
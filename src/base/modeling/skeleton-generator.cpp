@@ -52,7 +52,7 @@ void SkeletonGenerator::compute() {
     }
 
     // Douglas-Peucker Algorithm for external axis
-    CDP cdp(points, externalAxis, chords, cdpThreshold, cdpCylindricalImp, cdpDistanceImp);
+    CDP cdp(externalAxis, cdpErrors, cdpThreshold, cdpOptimal);
     cdp.compute();
     externalAxisSkeleton = cdp.getSkeleton();
 
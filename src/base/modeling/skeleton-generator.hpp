@@ -8,20 +8,20 @@
 
 class SkeletonGenerator {
 public:
+    /*
+    cdpErrors holds the Douglas-Peucker errors of the external axis,
+    it can be shared by the generators of different thresholds.
+    */
     SkeletonGenerator(
-        const std::vector<glm::vec2> & points,
         const std::vector<std::vector<glm::vec2>> & externalAxis,
         const std::vector<std::vector<glm::vec2>> & internalAxis,
-        const std::vector<Geometry::Edge> & chords,
+        CDPErrorTable & cdpErrors,
         float cdpThreshold,
-        float cdpDistanceImp,
-        float cdpCylindricalImp
+        bool cdpOptimal = false
     ):
-    points(points),
-    externalAxis(externalAxis), internalAxis(internalAxis),
-    chords(chords), cdpThreshold(cdpThreshold),
-    cdpDistanceImp(cdpDistanceImp),
-    cdpCylindricalImp(cdpCylindricalImp)
+    cdpErrors(cdpErrors), cdpThreshold(cdpThreshold),
+    cdpOptimal(cdpOptimal),
+    externalAxis(externalAxis), internalAxis(internalAxis)
     {}
 
     void compute();
@@ -39,12 +39,10 @@ public:
     }
 
 private:
-    const std::vector<glm::vec2> & points;
-    const std::vector<Geometry::Edge> & chords;
-    
+    CDPErrorTable & cdpErrors;
+
     float cdpThreshold;
-    float cdpDistanceImp;
-    float cdpCylindricalImp;
+    bool cdpOptimal;
 
     std::vector<std::vector<glm::vec2>> externalAxis;
     std::vector<std::vector<glm::vec2>> internalAxis;
@@ -1,67 +1,157 @@
 #include "skining-generator.hpp"
 
-static bool segmentIntersectMesh(
-  glm::vec3 segA, glm::vec3 segB,
-  std::vector<glm::vec3> & vertices,
-  std::vector<glm::uvec3> & faces
-) {
-  for(unsigned t=0; t<faces.size(); t++) {
-    auto v1 = vertices[faces[t].x];
-    auto v2 = vertices[faces[t].y];
-    auto v3 = vertices[faces[t].z];
-    if(
-      v1 != segA && v2 != segA && v3 != segA
-    ) {
-      glm::vec3 p = Geometry::planeToLineIntersection(
-        v1, v2, v3,
-        segA, segB
-      );
-      if(glm::dot(segB-segA, p-segA) > 0 && glm::l2Norm(segB-segA)>glm::l2Norm(p-segA)) {
-        // If the intersection point is inside the segment
-        return true;
-      }
+#include "bone-heat-solver.hpp"
+
+#include <parallel.hpp>
+
+/*
+True if the segment crosses a triangle of the mesh,
+the triangles having segA as vertex excepted.
+*/
+bool SkiningGenerator::segmentIntersectMesh(
+  const glm::vec3 & segA, const glm::vec3 & segB
+) const {
+  return facesTree.findAny(
+    [&](const glm::vec3 & mins, const glm::vec3 & maxs) {
+      return Geometry::segmentIntersectBox(segA, segB, mins, maxs);
+    },
+    [&](unsigned t) {
+      auto & v1 = vertices[faces[t].x];
+      auto & v2 = vertices[faces[t].y];
+      auto & v3 = vertices[faces[t].z];
+      return v1 != segA && v2 != segA && v3 != segA
+        && Geometry::segmentIntersectTriangle(segA, segB, v1, v2, v3);
     }
-  }
-  return false;
+  );
 }
 
+/*
+Bones by increasing distance from the vertex, the first bone in case of tie.
+The distance is the one to the bone segment if toSegment, the sum of the
+distances to its joints otherwise. The joints are in the bone box, so the
+distance to the box bounds the first one, twice this distance the second one
+(slightly reduced for the rounding errors).
+distance is set to the distance to the returned bone.
+Returns -1 (and FLT_MAX as distance) if there is no bone.
+*/
 const int SkiningGenerator::findVertexClosestVisibleBoneIndex(
-    const glm::vec3 & vertex
-) {
-  float minDistance = FLT_MAX;
-  int targetBoneIndex = -1;
-  for(int i=0; i<rigging.getBones().size(); i++) {
-    auto & bone = rigging.getBones().at(i);
-    // glm::vec3 projOnBone = Geometry::projectPointOnLine(
-    //   bone.getA().getPoint(), bone.getB().getPoint(),
-    //   vertex
-    // );
-    // bool intersectMesh = segmentIntersectMesh(
-    //   vertex, projOnBone,
-    //   vertices, faces
-    // );
-    // auto distance = glm::distance(projOnBone,vertex);
+    const glm::vec3 & vertex,
+    bool toSegment,
+    float & distance
+) const {
+  auto & bones = rigging.getBones();
+  auto boneDistance = [&](unsigned i) {
+    if(toSegment) {
+      return glm::distance(vertex, Geometry::closestPointOnSegment(
+        vertex, bones[i].getA().getPoint(), bones[i].getB().getPoint()
+      ));
+    }
+    return glm::distance(bones[i].getA().getPoint(), vertex)
+      + glm::distance(bones[i].getB().getPoint(), vertex);
+  };
 
-    auto distance = 
-      glm::distance(bone.getA().getPoint(), vertex)+
-      glm::distance(bone.getB().getPoint(), vertex);
-    if(minDistance > distance) {
-      targetBoneIndex = i;
-      minDistance = distance;
+  int closestBoneIndex = -1;
+  int targetBoneIndex = bonesTree.visitClosest(
+    [&](const glm::vec3 & mins, const glm::vec3 & maxs) {
+      return (toSegment ? 0.9999f : 1.9999f)*Geometry::pointToBoxDistance(vertex, mins, maxs);
+    },
+    boneDistance,
+    [&](unsigned i) {
+      if(closestBoneIndex == -1) closestBoneIndex = i;
+      if(!visibility) return true;
+      glm::vec3 projOnBone = Geometry::closestPointOnSegment(
+        vertex, bones[i].getA().getPoint(), bones[i].getB().getPoint()
+      );
+      return !segmentIntersectMesh(vertex, projOnBone);
     }
-  }
+  );
+  if(targetBoneIndex == (int)UINT_MAX) targetBoneIndex = closestBoneIndex;
 
   if(targetBoneIndex==-1) {
     std::cerr << "No bone found for vertex " << std::endl;
     assert(false);
+    distance = FLT_MAX;
+    return -1;
   }
 
+  distance = boneDistance(targetBoneIndex);
   return targetBoneIndex;
 }
 
+/*
+Each vertex receives a heat 1/d^2 from its closest bone at the distance d.
+The weights under minWeight are dropped, the 4 largest ones are kept
+and normalized.
+*/
+void SkiningGenerator::computeBoneHeat() {
+  if(rigging.getBones().empty()) return;
+  const float minWeight = 0.01f;
+  const float minDistance = 1e-5f;
+
+  std::vector<unsigned> closestBones(vertices.size());
+  std::vector<float> heats(vertices.size());
+  parallelFor(vertices.size(), [&](unsigned i) {
+    float distance;
+    closestBones[i] = findVertexClosestVisibleBoneIndex(vertices[i], true, distance);
+    distance = glm::max(distance, minDistance);
+    heats[i] = 1.0f/(distance*distance);
+  });
+
+  SkinWeights & skin = rigging.getSkinWeights();
+  std::vector<std::vector<float>> weights;
+  if(!heatSolver->solve(heats, closestBones, rigging.getBones().size(), weights)) {
+    // Rigid skinning on the closest bones
+    for(unsigned i=0; i<vertices.size(); i++) {
+      skin.setWeight(i, closestBones[i], 1.0f);
+    }
+    return;
+  }
+
+  parallelFor(vertices.size(), [&](unsigned i) {
+    for(unsigned b=0; b<weights.size(); b++) {
+      if(weights[b][i] >= minWeight) skin.setWeight(i, b, weights[b][i]);
+    }
+    skin.normalize(i);
+  });
+}
+
 void SkiningGenerator::compute() {
+  auto & bones = rigging.getBones();
+  if(bones.empty()) return;
+  std::vector<glm::vec3> mins, maxs;
+  mins.reserve(bones.size());
+  maxs.reserve(bones.size());
+  for(auto & bone : bones) {
+    mins.push_back(glm::min(bone.getA().getPoint(), bone.getB().getPoint()));
+    maxs.push_back(glm::max(bone.getA().getPoint(), bone.getB().getPoint()));
+  }
+  bonesTree.build(mins, maxs);
+
+  if(visibility) {
+    mins.resize(faces.size());
+    maxs.resize(faces.size());
+    for(unsigned t=0; t<faces.size(); t++) {
+      auto & v1 = vertices[faces[t].x];
+      auto & v2 = vertices[faces[t].y];
+      auto & v3 = vertices[faces[t].z];
+      mins[t] = glm::min(glm::min(v1, v2), v3);
+      maxs[t] = glm::max(glm::max(v1, v2), v3);
+    }
+    facesTree.build(mins, maxs);
+  }
+
+  if(heatSolver) {
+    computeBoneHeat();
+    return;
+  }
+
+  // Queries are independent, weights are set afterwards
+  std::vector<int> vertexBones(vertices.size());
+  parallelFor(vertices.size(), [&](unsigned i) {
+    float distance;
+    vertexBones[i] = findVertexClosestVisibleBoneIndex(vertices[i], false, distance);
+  });
   for(unsigned i=0; i<vertices.size(); i++) {
-    int boneIndex = findVertexClosestVisibleBoneIndex(vertices[i]);
-    if(boneIndex>=0) rigging.getBonesSkins().at(boneIndex).setSkinWeight(i, 1.0f);
+    if(vertexBones[i]>=0) rigging.getSkinWeights().setWeight(i, vertexBones[i], 1.0f);
   }
 }
@@ -5,13 +5,25 @@
 #include <geometry/geometry.hpp>
 #include "rigging.hpp"
 
+class BoneHeatSolver;
+
 class SkiningGenerator {
 public:
+    /*
+    Without heat solver, each vertex is bound to its closest bone only.
+    With the bone heat solver of this mesh, the weights are smoothly
+    diffused from the closest bones (up to 4 bones per vertex).
+    With visibility, the closest bone of a vertex is the closest one it can
+    see without crossing the mesh (the closest bone if it sees none).
+    */
     SkiningGenerator(
         Rigging & rigging,
         const std::vector<glm::vec3> & vertices,
-        const std::vector<glm::uvec3> & faces
-    ): rigging(rigging), vertices(vertices), faces(faces) {
+        const std::vector<glm::uvec3> & faces,
+        bool visibility = false,
+        BoneHeatSolver * heatSolver = nullptr
+    ): rigging(rigging), vertices(vertices), faces(faces),
+    visibility(visibility), heatSolver(heatSolver) {
         rigging.initSkinning(vertices.size());
     }
 
@@ -23,9 +35,24 @@ private:
     const std::vector<glm::vec3> & vertices;
     const std::vector<glm::uvec3> & faces;
 
+    bool visibility = false;
+    BoneHeatSolver * heatSolver = nullptr;
+
+    // Trees of the bones segments and of the mesh triangles
+    Geometry::BVH bonesTree;
+    Geometry::BVH facesTree;
+
+    bool segmentIntersectMesh(
+        const glm::vec3 & segA, const glm::vec3 & segB
+    ) const;
+
     const int findVertexClosestVisibleBoneIndex(
-        const glm::vec3 & vertex
-    );
+        const glm::vec3 & vertex,
+        bool toSegment,
+        float & distance
+    ) const;
+
+    void computeBoneHeat();
 
 };
 
@@ -0,0 +1,46 @@
+#ifndef _SKETCHY_PARALLEL_
+#define _SKETCHY_PARALLEL_
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <functional>
+
+/*
+Call f(i) for each i in [0, count) on up to maxThreads threads
+(the hardware concurrency if 0). Iterations are handed out one by one,
+so that long ones do not hold back the others.
+Returns when every call is done. f must be safe to call concurrently.
+*/
+inline void parallelFor(
+    unsigned count,
+    const std::function<void(unsigned)> & f,
+    unsigned maxThreads = 0
+) {
+    unsigned threadCount = maxThreads > 0 ? maxThreads : std::thread::hardware_concurrency();
+    if(threadCount > count) threadCount = count;
+    if(threadCount <= 1) {
+        for(unsigned i=0; i<count; i++) f(i);
+        return;
+    }
+
+    std::atomic<unsigned> next(0);
+    auto work = [&]() {
+        for(unsigned i=next++; i<count; i=next++) {
+            f(i);
+        }
+    };
+
+    // The calling thread works too
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount-1);
+    for(unsigned t=0; t<threadCount-1; t++) {
+        threads.emplace_back(work);
+    }
+    work();
+    for(auto & thread : threads) {
+        thread.join();
+    }
+}
+
+#endif
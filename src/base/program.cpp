@@ -18,12 +18,16 @@
 #define SHADER_FILENAME_COVER_VERTEX "src/shaders/coverVertex.glsl"
 #define SHADER_FILENAME_COVER_FRAGMENT "src/shaders/coverFragment.glsl"
 
+#define SHADER_FILENAME_BONE_GIZMO_VERTEX "src/shaders/boneGizmoVertexShader.glsl"
+#define SHADER_FILENAME_BONE_GIZMO_FRAGMENT "src/shaders/boneGizmoFragmentShader.glsl"
+
 Program * Program::instancePhong = nullptr;
 Program * Program::instanceShadowMap = nullptr;
 Program * Program::instanceSingleColor = nullptr;
 Program * Program::instanceDrawing = nullptr;
 Program * Program::instanceDrawingWorld = nullptr;
 Program * Program::instanceCover = nullptr;
+Program * Program::instanceBoneGizmo = nullptr;
 
 Program * Program::getInstancePhong() {
     if(instancePhong  == nullptr) {
@@ -85,6 +89,16 @@ Program * Program::getInstanceCover() {
     return instanceCover;
 }
 
+Program * Program::getInstanceBoneGizmo() {
+    if(instanceBoneGizmo  == nullptr) {
+        instanceBoneGizmo = new Program();
+        instanceBoneGizmo->vertexShaderFilename = SHADER_FILENAME_BONE_GIZMO_VERTEX;
+        instanceBoneGizmo->fragmentShaderFilename = SHADER_FILENAME_BONE_GIZMO_FRAGMENT;
+        instanceBoneGizmo->initProgram();
+    }
+    return instanceBoneGizmo;
+}
+
 void Program::subscribe() {
     if(programUserCount == 0) {
         initProgram();
@@ -124,4 +138,15 @@ void Program::initProgram() {
     loadShader(program, GL_FRAGMENT_SHADER, fragmentShaderFilename);
     glLinkProgram(program);
     getOpenGLError("linking program");
+
+    // Same order as the Uniform enum
+    static const char * uniformNames[UniformsCount] = {
+        "worldMat", "basicColor", "diffuseColor", "specularColor",
+        "shininess", "diffuseMap", "specularMap", "shininessMap",
+        "normalMap", "hasBones", "bonesCount", "lightProjViewMat",
+        "shadowMaps", "singleColor"
+    };
+    for(unsigned u=0; u<UniformsCount; u++) {
+        uniformLocations[u] = glGetUniformLocation(program, uniformNames[u]);
+    }
 }
@@ -7,6 +7,15 @@
 Holds singletons for each shader program.
 */
 class Program {
+public:
+    /*Uniforms set while rendering, their locations are asked once per link.*/
+    enum Uniform {
+        UniformWorldMat, UniformBasicColor, UniformDiffuseColor, UniformSpecularColor,
+        UniformShininess, UniformDiffuseMap, UniformSpecularMap, UniformShininessMap,
+        UniformNormalMap, UniformHasBones, UniformBonesCount, UniformLightProjViewMat,
+        UniformShadowMaps, UniformSingleColor, UniformsCount
+    };
+
 protected:
     ~Program() {
         if(glIsProgram(program))
@@ -18,12 +27,16 @@ protected:
     static Program * instanceDrawing;
     static Program * instanceDrawingWorld;
     static Program * instanceCover;
+    static Program * instanceBoneGizmo;
 
     GLuint program;
     unsigned int programUserCount;
 
     const char * vertexShaderFilename;
     const char * fragmentShaderFilename;
+
+    // Locations of the uniforms in the linked program, -1 for the ones it has not
+    GLint uniformLocations[UniformsCount];
     
     void loadShader(GLuint program, GLenum type, const std::string &shaderFilename);
     void initProgram();
@@ -36,6 +49,7 @@ public:
     static Program * getInstanceDrawing();
     static Program * getInstanceDrawingWorld();
     static Program * getInstanceCover();
+    static Program * getInstanceBoneGizmo();
     
     /*Subscribe to the program. This compile the program if it was previously delete from the GPU.*/
     void subscribe();
@@ -44,6 +58,8 @@ public:
 
     /*Returns the program id.*/
     inline GLuint getProgram() { return program; }
+
+    inline GLint getUniformLocation(Uniform uniform) const { return uniformLocations[uniform]; }
 };
 
 #endif
@@ -1,8 +1,10 @@
 #ifndef _SKETCHY_UTILS_
 #define _SKETCHY_UTILS_
 
+#ifndef _SKETCHY_NO_OPENGL_
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#endif
 
 #include <glm/glm.hpp>
 #include <glm/ext.hpp>
@@ -19,9 +21,15 @@
 #include <cmath>
 #include <memory>
 #include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <cassert>
+#include <cfloat>
+#include <climits>
 
 #include <chrono>
 
+#ifndef _SKETCHY_NO_OPENGL_
 inline int getOpenGLError(const char * where) {
     int error = glGetError();
     if(error != GL_NO_ERROR) {
@@ -30,6 +38,7 @@ inline int getOpenGLError(const char * where) {
     }
     return error;
 }
+#endif
 
 inline long long getTimeMillis() {
     auto t = std::chrono::high_resolution_clock::now();
@@ -0,0 +1,181 @@
+/*
+Headless batch version of the modeling pipeline.
+Reads shape files (as saved by the "Save shape file" button) and writes,
+for each of them, the generated mesh (STL) and its rig (joints, bones and skin weights).
+No OpenGL context is created.
+*/
+
+#include <utils.hpp>
+#include <modeling/shape.hpp>
+#include <modeling/pipeline.hpp>
+
+static void showUsage(const char * name) {
+  std::cout << "Usage : " << name << " [options] shape_file [shape_file ...]" << std::endl
+    << "Options :" << std::endl
+    << "  -o, --output DIR              output directory (default : .)" << std::endl
+    << "  --sub-sampling N              shape sampling (default : 20)" << std::endl
+    << "  --pruning-threshold F         medial axis pruning threshold (default : 0.5)" << std::endl
+    << "  --smoothing-size N            medial axis smoothing size (default : 2)" << std::endl
+    << "  --cylinder-sampling N         vertices in a cylinder section (default : 20)" << std::endl
+    << "  --cdp-threshold F             Douglas-Peucker global threshold (default : 0.3)" << std::endl
+    << "  --cdp-cyl-weight F            Douglas-Peucker cylindrical error weight (default : 1)" << std::endl
+    << "  --cdp-dist-weight F           Douglas-Peucker distance error weight (default : 1)" << std::endl
+    << "  --cdp-optimal                 fewest joints under the Douglas-Peucker threshold" << std::endl
+    << "  --junction-smoothing          least-squares meshes smoothing of the junctions" << std::endl
+    << "  --junction-rings N            cylinder vertex rings smoothed too (default : 2)" << std::endl
+    << "  --skin-visibility             bind vertices to the closest bone they see" << std::endl
+    << "  --skin-heat                   smooth bone heat skin weights" << std::endl
+    << "  --debug-images                save the images of each step results in the output directory" << std::endl
+    << "  -h, --help                    show this message" << std::endl;
+}
+
+/*
+Write the rig of a mesh :
+- the joints with their id and position
+- the bones with their id and the ids of their joints
+- for each bone, the vertices with a non zero skin weight
+*/
+static void writeRig(const std::string & filename, Rigging & rigging) {
+  std::ofstream out(filename);
+
+  out << "joints " << rigging.getJoints().size() << std::endl;
+  for(auto & joint : rigging.getJoints()) {
+    auto & p = joint.getPoint();
+    out << joint.getId() << " " << p.x << " " << p.y << " " << p.z << std::endl;
+  }
+
+  out << "bones " << rigging.getBones().size() << std::endl;
+  for(auto & bone : rigging.getBones()) {
+    out << bone.getId() << " " << bone.getA().getId() << " " << bone.getB().getId() << std::endl;
+  }
+
+  // Vertices weights grouped by bone
+  const SkinWeights & skin = rigging.getSkinWeights();
+  std::vector<std::vector<std::pair<unsigned, float>>> bonesWeights(rigging.getBones().size());
+  for(unsigned i=0; i<skin.getWeights().size(); i++) {
+    if(skin.getWeights()[i] != 0.0f) {
+      bonesWeights[skin.getBoneIndices()[i]].push_back({
+        i/SkinWeights::influencesCount, skin.getWeights()[i]
+      });
+    }
+  }
+
+  out << "skins " << bonesWeights.size() << std::endl;
+  for(unsigned b=0; b<bonesWeights.size(); b++) {
+    out << rigging.getBones()[b].getId() << " " << bonesWeights[b].size() << std::endl;
+    for(auto & w : bonesWeights[b]) {
+      out << w.first << " " << w.second << std::endl;
+    }
+  }
+}
+
+static std::string shapeBaseName(const std::string & filename) {
+  auto slash = filename.find_last_of("/\\");
+  std::string name = slash == std::string::npos ? filename : filename.substr(slash+1);
+  auto dot = name.find_last_of('.');
+  if(dot != std::string::npos && dot > 0) name = name.substr(0, dot);
+  return name;
+}
+
+int main(int argc, char ** argv) {
+  PipelineParameters parameters;
+  // Written in the background, waits for the last images when destroyed
+  DebugImageSink debugSink;
+  parameters.debugSink = &debugSink;
+  std::string outputDir = ".";
+  std::vector<std::string> shapeFiles;
+
+  for(int i=1; i<argc; i++) {
+    std::string arg = argv[i];
+    bool hasValue = i+1 < argc;
+    if(arg == "-h" || arg == "--help") {
+      showUsage(argv[0]);
+      return EXIT_SUCCESS;
+    }
+    else if((arg == "-o" || arg == "--output") && hasValue) {
+      outputDir = argv[++i];
+    }
+    else if(arg == "--sub-sampling" && hasValue) {
+      parameters.subSampling = glm::max(1, atoi(argv[++i]));
+    }
+    else if(arg == "--pruning-threshold" && hasValue) {
+      parameters.pruningThreshold = atof(argv[++i]);
+    }
+    else if(arg == "--smoothing-size" && hasValue) {
+      parameters.smoothMaskSize = atoi(argv[++i]);
+    }
+    else if(arg == "--cylinder-sampling" && hasValue) {
+      parameters.cylinderSampling = glm::max(1, atoi(argv[++i]));
+    }
+    else if(arg == "--cdp-threshold" && hasValue) {
+      parameters.cdpThreshold = atof(argv[++i]);
+    }
+    else if(arg == "--cdp-cyl-weight" && hasValue) {
+      parameters.cdpCylindricalImp = atof(argv[++i]);
+    }
+    else if(arg == "--cdp-dist-weight" && hasValue) {
+      parameters.cdpDistanceImp = atof(argv[++i]);
+    }
+    else if(arg == "--cdp-optimal") {
+      parameters.cdpOptimal = true;
+    }
+    else if(arg == "--junction-smoothing") {
+      parameters.junctionSmoothing = true;
+    }
+    else if(arg == "--junction-rings" && hasValue) {
+      parameters.junctionRings = glm::max(0, atoi(argv[++i]));
+    }
+    else if(arg == "--skin-visibility") {
+      parameters.skinVisibility = true;
+    }
+    else if(arg == "--skin-heat") {
+      parameters.skinHeat = true;
+    }
+    else if(arg == "--debug-images") {
+      debugSink.setLevel(DebugImageSink::AsyncDisk);
+    }
+    else if(arg.size() > 0 && arg[0] == '-') {
+      std::cerr << "Unknown option " << arg << std::endl;
+      showUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+    else {
+      shapeFiles.push_back(arg);
+    }
+  }
+
+  if(shapeFiles.size() == 0) {
+    showUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  int failures = 0;
+  for(auto & shapeFile : shapeFiles) {
+    long long start = getTimeMillis();
+
+    std::vector<glm::vec2> points;
+    if(!readShapeFile(shapeFile, points)) {
+      std::cerr << "Can't read shape file " << shapeFile << std::endl;
+      failures += 1;
+      continue;
+    }
+
+    std::string base = outputDir + "/" + shapeBaseName(shapeFile);
+    debugSink.setPrefix(base + "-");
+
+    Pipeline pipeline(points, parameters);
+    if(!pipeline.compute()) {
+      std::cerr << "No mesh generated for " << shapeFile << std::endl;
+      failures += 1;
+      continue;
+    }
+
+    writeSTL(base + ".stl", pipeline.getFaces(), pipeline.getVertices());
+    writeRig(base + ".rig", pipeline.getRigging());
+
+    std::cout << shapeFile << " -> " << base << ".stl, " << base << ".rig"
+      << " (" << getTimeMillis()-start << " ms)" << std::endl;
+  }
+
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -22,8 +22,7 @@
 #include <modeling/chords-generator.hpp>
 #include <modeling/mesh-generator.hpp>
 #include <mesh-skeleton.hpp>
-
-#include <modeling/rigging-mesh.hpp>
+#include <bone-gizmos.hpp>
 
 #include <geometry/draw-2d.hpp>
 
@@ -33,6 +32,8 @@
 
 #include <modeling/operations.h>
 
+#include <modeling/pipeline-job.hpp>
+
 
 Renderer * renderer = nullptr;
 Mesh * selectedMesh = nullptr;
@@ -268,16 +269,20 @@ bool drawing_render = true;
 
 int im_resolution_w = 300;
 int im_resolution_h = 300;
-
-glm::vec3 chordColor = {0, 200, 0};
-glm::vec3 axisColor = {0, 200, 200};
-glm::vec3 axisPointColor = {0, 20, 200};
-glm::vec3 shapeColor = {150, 0, 0};
-glm::vec3 shapePointColor = {0, 0, 220};
-glm::vec3 skeletonPointColor = {200, 200, 0};
-glm::vec3 skeletonColor0 = {200, 0, 0};
-glm::vec3 skeletonColor1 = {0, 200, 0};
-glm::vec3 skeletonColor2 = {0, 0, 200};
+bool save_debug_images = true;
+// PNG files are written in the background
+DebugImageSink debugImageSink(DebugImageSink::AsyncDisk);
+
+// Pipeline computed on a worker thread, and the last uploaded result
+PipelineJob pipelineJob;
+Pipeline * lastPipeline = nullptr;
+// Recompute the last result when a slider changes
+bool live_update = true;
+// Douglas-Peucker slider dragged : the skeleton is recomputed each frame
+bool cdp_dragging = false;
+// Skeleton skipped while dragging, recomputed on the slider release
+bool skeleton_update_pending = false;
+int skeleton_time_budget = 30; // ms
 
 glm::vec3 cylinderMeshColor = {0, 200, 200};
 glm::vec3 cylinderMeshColorUnselected = {0, 100, 100};
@@ -285,11 +290,10 @@ glm::vec3 mergedMeshColor = {200, 0, 0};
 glm::vec3 skeletonMeshColor = {0, 250, 0};
 glm::vec3 skeletonMeshColorHighLight = {255, 255, 255};
 
-std::vector<Renderable *> skeletonMesh;
+BoneGizmos * boneGizmos = nullptr;
 Mesh * generatedMesh = nullptr;
 MeshSkeleton * generatedMeshSkeleton = nullptr;
 
-std::vector<Renderable *> skeletonFirstMesh;
 Mesh * firstMesh = nullptr;
 MeshSkeleton * generatedFirstMeshSkeleton = nullptr;
 
@@ -311,6 +315,10 @@ int ma_prun_count = 3;
 int sub_sampling = 20;
 
 int cylinder_sampling = 20;
+bool junction_smoothing = false;
+int junction_rings = 2;
+bool skin_heat = false;
+bool skin_visibility = false;
 
 int smooth_mask_size = 2;
 
@@ -320,81 +328,38 @@ int focus_bone_index = 0;
 char textureFilename[2048];
 bool useTexture = false;
 
+/*
+Replace the skeleton of the generated mesh and its bone gizmos,
+the mesh buffers are kept (only the skinning attributes are uploaded).
+*/
+void updateMeshSkeleton(Rigging & rigging) {
+  bones_count = rigging.getBones().size();
+
+  MeshSkeleton * previousSkeleton = generatedMeshSkeleton;
+  generatedMeshSkeleton = new MeshSkeleton(rigging);
+  generatedMesh->setSkeleton(generatedMeshSkeleton);
+  if(previousSkeleton) {
+    boneGizmos->removeSkeleton(previousSkeleton);
+    delete previousSkeleton;
+  }
+  // Skeleton gizmos
+  boneGizmos->addSkeleton(generatedMeshSkeleton, skeletonMeshColor);
+  boneGizmos->setVisible(generatedMeshSkeleton, show_skeleton);
+  if(focus_bone_index >= bones_count) focus_bone_index = 0;
+  boneGizmos->setHighlightedBone(generatedMeshSkeleton, focus_bone_index, skeletonMeshColorHighLight);
+}
+
 void computeSkeletonAndMeshes(
   const std::vector<glm::vec3> & meshVertices,
   const std::vector<glm::uvec3> & meshFaces,
-  Shape & shape,
-  std::vector<std::vector<glm::vec2>> & externalAxis,
-  std::vector<std::vector<glm::vec2>> & internalAxis,
-  std::vector<Geometry::Edge> & chords
+  Rigging & rigging
 ) {
-  std::cout << "External axis = " << externalAxis.size() << std::endl;
-  std::cout << "Internal axis = " << internalAxis.size() << std::endl;
-  std::cout << "Chords = " << chords.size() << std::endl;
 
-
-  // Full skeleton
-  SkeletonGenerator skelGen(
-    shape.getFullPoints(), externalAxis, internalAxis, chords,
-    cdp_threshold, importanceDistanceError, importanceCylindricalError);
-  skelGen.compute();
-
-  Rigging & rigging = skelGen.getRigging();
-  rigging.initSkinning(meshVertices.size());
-  SkiningGenerator skinGen(rigging, meshVertices, meshFaces);
-  skinGen.compute();
-
-  bones_count = rigging.getBonesSkins().size();
-  std::cout << "Bones : " << bones_count << std::endl;
-
-  {
-    std::vector<std::pair<glm::vec2, glm::vec2>> bones2D;
-    std::vector<glm::vec2> bonesPoints;
-    for(auto & bone : skelGen.getRigging().getBones()) {
-      bones2D.push_back({
-        glm::vec2(bone.getA().getPoint()),
-        glm::vec2(bone.getB().getPoint())
-      });
-      bonesPoints.push_back(glm::vec2(bone.getA().getPoint()));
-      bonesPoints.push_back(glm::vec2(bone.getB().getPoint()));
-    }
-    Geometry::DrawBuilder builder(im_resolution_w, im_resolution_h);
-    builder.setExtraPoints(shape.getFullPoints());
-    builder.addExtraPoints(bonesPoints);
-    builder.drawSegments(bones2D, skeletonColor0);
-    builder.drawShape(true, shape.getFullPoints(), shapeColor);
-    builder.drawPoints(shape.getFullPoints(), shapePointColor);
-    builder.save("im-080-skeleton.png");
-  }
-  {
-    Geometry::DrawBuilder builder(im_resolution_w, im_resolution_h);
-    builder.setExtraPoints(shape.getFullPoints());
-    for(auto ax : skelGen.getExternalAxisSkeleton()) {
-      builder.drawShape(false, ax, skeletonColor0);
-      builder.drawPoints(ax, axisPointColor);
-    }
-    for(auto ax : skelGen.getInternalAxisSkeleton()) {
-      builder.drawShape(false, ax, skeletonColor1);
-      builder.drawPoints(ax, axisPointColor);
-    }
-    for(auto ax : skelGen.getJunctionAxisSkeleton()) {
-      builder.drawShape(false, ax, skeletonColor2);
-      builder.drawPoints(ax, axisPointColor);
-    }
-    builder.drawShape(true, shape.getFullPoints(), shapeColor);
-    builder.drawPoints(shape.getFullPoints(), shapePointColor);
-    builder.save("im-090-skeleton-details.png");
-  }
-  
   // std::vector<glm::vec3> meshColors;
   // meshColors.reserve(meshVertices.size());
-  // auto & skinGroup = rigging.getBonesSkins().at(focus_bone_index);
   // for(unsigned v=0; v<meshVertices.size(); v++) {
-  //   auto weight_ = skinGroup.getVertexSkinWeights().find(v);
-  //   if(weight_ != skinGroup.getVertexSkinWeights().end()) {
-  //     float weight = weight_->second;
-  //     meshColors.push_back({0.f, weight, 0.f});
-  //   }
+  //   float weight = rigging.getSkinWeights().getWeight(v, focus_bone_index);
+  //   meshColors.push_back({0.f, weight, 0.f});
   // }
 
   // Meshes rendering
@@ -402,6 +367,8 @@ void computeSkeletonAndMeshes(
   // Mesh
   if(generatedMesh!=nullptr) {
     renderer->removeRenderable(generatedMesh);
+    delete generatedMesh;
+    generatedMesh = nullptr;
   }
   if(useTexture) {
     auto geo = new MeshGeometry(meshVertices, meshFaces);
@@ -418,185 +385,98 @@ void computeSkeletonAndMeshes(
       MeshMaterial::meshGetSimplePhongMaterial(cylinderMeshColor*0.01f, cylinderMeshColor*0.001f, 1)
     );
   }
+  generatedMesh->shouldRender = show_mesh;
   renderer->addRenderable(generatedMesh);
   // Skeleton of te mesh
-  generatedMeshSkeleton = new MeshSkeleton(rigging);
-  for(unsigned b=0; b<generatedMeshSkeleton->getBones().size(); b++) {
-    for(unsigned v=0; v<generatedMesh->getGeometry()->getVertexPositions().size(); v++) {
-      auto coef = rigging.getBonesSkins().at(b).getVertexSkinWeights().at(v);
-      generatedMeshSkeleton->setVerticesCoef(
-        b, v, coef
-      );
-    }
-  }
-  generatedMeshSkeleton->initVerticesTranformsCoef();
-  generatedMesh->setSkeleton(generatedMeshSkeleton);
-  // Skeleton mesh
-  if(skeletonMesh.size()>0) {
-    for(auto m : skeletonMesh)
-      renderer->removeRenderable(m);
-  }
-  skeletonMesh = generatedMeshSkeleton->getSkeletonMesh(skeletonMeshColor);
-  for(auto m : skeletonMesh) {
-    m->setDepthTest(false);
-    renderer->addRenderable(m);
-  }
-  ((Mesh*)skeletonMesh.at(focus_bone_index))->getMaterial()->setBasicColor(skeletonMeshColorHighLight);
+  updateMeshSkeleton(rigging);
 
   drawing_render = false;
 }
 
+PipelineParameters getPipelineParameters() {
+  PipelineParameters parameters;
+  parameters.subSampling = sub_sampling;
+  parameters.pruningThreshold = pruning__threshold;
+  parameters.smoothMaskSize = smooth_mask_size;
+  parameters.cylinderSampling = cylinder_sampling;
+  parameters.junctionSmoothing = junction_smoothing;
+  parameters.junctionRings = junction_rings;
+  parameters.skinHeat = skin_heat;
+  parameters.skinVisibility = skin_visibility;
+  parameters.cdpThreshold = cdp_threshold;
+  parameters.cdpCylindricalImp = importanceCylindricalError;
+  parameters.cdpDistanceImp = importanceDistanceError;
+  parameters.debugSink = &debugImageSink;
+  parameters.debugImageWidth = im_resolution_w;
+  parameters.debugImageHeight = im_resolution_h;
+  return parameters;
+}
+
 void testPipeline(
-  Shape shape
+  const std::vector<glm::vec2> & points
 ) {
+  pipelineJob.start(points, getPipelineParameters());
+}
 
-  {
-    Geometry::DrawBuilder builder(im_resolution_w, im_resolution_h);
-    builder.drawShape(true, shape.getFullPoints(), shapeColor);
-    builder.drawPoints(shape.getFullPoints(), shapePointColor);
-    builder.save("im-000-shape.png");
-  }
-
-  // Delaunay constrained triangulation
-  ConstrainedDelaunayTriangulation2D d(shape.getSubSampledPoints());
-  auto trianglesSub = d.getTriangles();
-  auto chordsSub = d.getEdges();
-  auto triangles = shape.convertToFullTriangleSet(trianglesSub);
-  auto chords = shape.convertToFullEdgeSet(chordsSub);
-  {
-    Geometry::DrawBuilder builder(im_resolution_w, im_resolution_h);
-    builder.drawTriangles(shape.getFullPoints(), triangles, chordColor);
-    builder.drawShape(true, shape.getFullPoints(), shapeColor);
-    builder.drawPoints(shape.getFullPoints(), shapePointColor);
-    builder.save("im-010-delaunay-triangulation.png");
-  }
-
-  // The raw medial axis
-  MedialAxisGenerator medial(shape.getSubSampledPoints(), trianglesSub);
-  // medial.compute();
-  auto midPoints = medial.computeMidPoints();
-  for(unsigned i=0; i<3; i++){
-    if(i==1) {
-      // for(int ii=1; ii<=ma_prun_count; ii++) {
-      //   // medial.pruning(ma_prun_depth*(ii/ma_prun_count));
-      //   medial.pruning(ma_prun_depth);
-      // }
-
-      smoothing s;
-      s.insignificantBranchesRemoval(
-        medial, pruning__threshold, shape.getSubSampledPoints()
-      );
-
-    }
-    if(i==2) {
-      medial.smooth(smooth_mask_size);
-    }
-    auto axis = medial.getMedialAxis();
-    std::vector<std::pair<glm::vec2, glm::vec2>> segments;
-    for(auto ax : axis.getPoints()) {
-      for(auto s : ax->getAdjs()) {
-        segments.emplace_back(ax->getPoint(), s->getPoint());
-      }
+/*
+Recompute the steps of the last result depending on the changed sliders.
+The pipeline is only read by the upload, so the job can take it :
+it is given back if the update is canceled or fails.
+*/
+void updatePipeline() {
+  if(!live_update || lastPipeline == nullptr || pipelineJob.isRunning()) return;
+
+  PipelineParameters parameters = getPipelineParameters();
+  const bool changed = lastPipeline->setParameters(parameters);
+
+  // Synchronous while dragging, skipped if it does not fit in the frame budget.
+  // The other steps, or a skeleton out of budget, wait for the slider release.
+  // Only the skeleton changes, the mesh is kept if there is one.
+  if(cdp_dragging) {
+    if(!changed) return;
+    if(!lastPipeline->updateSkeleton(skeleton_time_budget)) {
+      skeleton_update_pending = true;
+      return;
+    }
+    if(generatedMesh) {
+      updateMeshSkeleton(lastPipeline->getRigging());
     }
-    std::vector<glm::vec2> pointsSeg;
-    for(auto seg : segments) {
-        pointsSeg.push_back(seg.first);
-        pointsSeg.push_back(seg.second);
-    }
-    Geometry::DrawBuilder builder(im_resolution_w, im_resolution_h);
-    builder.addExtraPoints(shape.getFullPoints());
-    builder.addExtraPoints(pointsSeg);
-    builder.drawSegments(segments, axisColor);
-    builder.drawPoints(pointsSeg, axisPointColor);
-    builder.drawShape(true, shape.getFullPoints(), shapeColor);
-    builder.drawPoints(shape.getFullPoints(), shapePointColor);
-    if(i==0) {
-      builder.save("im-020-raw-medial-axis.png");
-      builder.drawTriangles(shape.getFullPoints(), triangles, chordColor);
-      builder.save("im-020-raw-medial-axis-with-triangles.png");
-    }
-    if(i==1) builder.save("im-030-pruned-medial-axis.png");
-    if(i==2) builder.save("im-040-pruned-smoothed-medial-axis.png");
-  }
-
-  // External axis of the medial axis tree
-  auto externalAxis = medial.extractExternalAxis();
-  {
-    Geometry::DrawBuilder builder(im_resolution_w, im_resolution_h);
-    builder.setExtraPoints(shape.getFullPoints());
-    for(auto ax : externalAxis) {
-      builder.drawShape(false, ax, axisColor);
-      builder.drawPoints(ax, axisPointColor);
-      std::cout << "External axis size : " << ax.size() << std::endl;
-    }
-    builder.drawShape(true, shape.getFullPoints(), shapeColor);
-    builder.drawPoints(shape.getFullPoints(), shapePointColor);
-    builder.save("im-050-external-medial-axis.png");
-  }
-  // Internal axis of the medial axis tree
-  auto internalAxis = medial.extractInternalAxis();
-  {
-    Geometry::DrawBuilder builder(im_resolution_w, im_resolution_h);
-    builder.setExtraPoints(shape.getFullPoints());
-    for(auto ax : internalAxis) {
-      builder.drawShape(false, ax, axisColor);
-      builder.drawPoints(ax, axisPointColor);
+    else {
+      computeSkeletonAndMeshes(
+        lastPipeline->getVertices(), lastPipeline->getFaces(),
+        lastPipeline->getRigging()
+      );
     }
-    builder.drawShape(true, shape.getFullPoints(), shapeColor);
-    builder.drawPoints(shape.getFullPoints(), shapePointColor);
-    builder.save("im-060-internal-medial-axis.png");
-  }
-
-  if(externalAxis.size()==0 && internalAxis.size()==0) {
-    std::cout << "No axis !!!!! Hint : Reduce the prunning threshold" << std::endl;
     return;
   }
+  // A canceled or failed update is not redone until a slider changes
+  if(!changed && !skeleton_update_pending) return;
+  skeleton_update_pending = false;
+  pipelineJob.update(lastPipeline, parameters);
+  lastPipeline = nullptr;
+}
 
-  ChordsGenerator chordsGen(
-    shape.getFullPoints(),
-    externalAxis, internalAxis
-  );
-  chordsGen.compute();
-  std::vector<Geometry::Edge> optiChords = chordsGen.getChords();
-  auto axisPointToChord = chordsGen.axisPointToChord;
-  {
-    Geometry::DrawBuilder builder(im_resolution_w, im_resolution_h);
-    builder.setExtraPoints(shape.getFullPoints());
-    builder.drawEdges(shape.getFullPoints(), optiChords, chordColor);
-
-    for(auto ax : externalAxis) {
-      builder.drawShape(false, ax, axisColor);
-      builder.drawPoints(ax, axisPointColor);
-    }
-    for(auto ax : internalAxis) {
-      builder.drawShape(false, ax, axisColor);
-      builder.drawPoints(ax, axisPointColor);
-    }
-
-    builder.drawShape(true, shape.getFullPoints(), shapeColor);
-    builder.drawPoints(shape.getFullPoints(), shapePointColor);
-    builder.save("im-070-chords.png");
+/*Upload the meshes of the pipeline once it is done.*/
+void uploadPipelineResult() {
+  // The pipeline of a canceled or failed update, unless a newer one is there
+  Pipeline * returned = pipelineJob.takeReturned();
+  if(returned) {
+    if(lastPipeline) delete returned;
+    else lastPipeline = returned;
   }
 
-  // Mesh vertices and faces
+  Pipeline * pipeline = pipelineJob.takeResult();
+  if(pipeline == nullptr) return;
 
-  MeshGenerator meshGen(
-    shape.getFullPoints(),
-    externalAxis, internalAxis,
-    optiChords, axisPointToChord, cylinder_sampling
-  );
-  meshGen.compute();
-  std::vector<glm::vec3> meshVertices = meshGen.getVertices();
-  std::vector<glm::uvec3> meshFaces = meshGen.getFaces();
-  std::cout << "Vertices : " << meshVertices.size() << std::endl;
-  std::cout << "Faces : " << meshFaces.size() << std::endl;
+  // The uploaded meshes copy the rigging, the previous pipeline is not used anymore
+  if(lastPipeline) delete lastPipeline;
+  lastPipeline = pipeline;
 
   // performSmoothing(meshVertices, meshFaces, 10);
 
   computeSkeletonAndMeshes(
-    meshVertices, meshFaces,
-    shape,
-    externalAxis, internalAxis, chords
+    pipeline->getVertices(), pipeline->getFaces(),
+    pipeline->getRigging()
   );
 }
 
@@ -641,8 +521,12 @@ void renderImGui() {
     // Cylindrical Douglas-Peucker threshold
     ImGui::Text("Douglas-Peucker");
     ImGui::SliderFloat("global threshold", &cdp_threshold, 0.0f, 1.0f);
+    cdp_dragging = ImGui::IsItemActive();
     ImGui::SliderFloat("Cyl error weight", &importanceCylindricalError, 0.0f, 5.0f);
+    cdp_dragging = cdp_dragging || ImGui::IsItemActive();
     ImGui::SliderFloat("Dist error weight", &importanceDistanceError, 0.0f, 5.0f);
+    cdp_dragging = cdp_dragging || ImGui::IsItemActive();
+    ImGui::SliderInt("Frame budget (ms)", &skeleton_time_budget, 1, 200);
     ImGui::Separator();
 
     ImGui::Text("Medial axis");
@@ -655,10 +539,17 @@ void renderImGui() {
 
     ImGui::Text("3D Generation");
     ImGui::SliderInt("Cylinder sampling", &cylinder_sampling, 1, 100);
+    ImGui::Checkbox("Smooth junctions", &junction_smoothing);
+    ImGui::SliderInt("Junction rings", &junction_rings, 0, 10);
+    ImGui::Checkbox("Bone heat skinning", &skin_heat);
+    ImGui::Checkbox("Visible bones only", &skin_visibility);
 
     ImGui::Text("Debug Images");
     ImGui::SliderInt("resolution w", &im_resolution_w, 100, 2000);
     ImGui::SliderInt("resolution h", &im_resolution_h, 100, 2000);
+    if(ImGui::Checkbox("Save debug images", &save_debug_images)) {
+      debugImageSink.setLevel(save_debug_images ? DebugImageSink::AsyncDisk : DebugImageSink::Off);
+    }
     ImGui::Separator();
 
     ImGui::Text("Texture");
@@ -680,16 +571,21 @@ void renderImGui() {
       for(auto p : drawing->getDrawing(drawing->drawingCount()-1)) {
         points.emplace_back(p.x, p.y);
       }
-      Shape shape(sub_sampling, points);
-      testPipeline(shape);
+      testPipeline(points);
     } ImGui::SameLine(); ImGui::Text("<---------------------------------------------");
+    ImGui::Checkbox("Live update", &live_update);
+    if(pipelineJob.isRunning()) {
+      ImGui::Text("Computing : %s", Pipeline::getStageName(pipelineJob.getStage()));
+      ImGui::SameLine();
+      if(ImGui::Button("Cancel")) {
+        pipelineJob.cancel();
+      }
+    }
     // Should show skeleton
     bool prev_show_skeleton = show_skeleton;
     ImGui::Checkbox("Show skeleton", &show_skeleton);
-    if(prev_show_skeleton!=show_skeleton) {
-      for(auto sk : skeletonMesh) {
-        ((Mesh*)sk)->shouldRender = show_skeleton;
-      }
+    if(prev_show_skeleton!=show_skeleton && generatedMeshSkeleton) {
+      boneGizmos->setVisible(generatedMeshSkeleton, show_skeleton);
     }
     // Should show mesh
     bool prev_show_mesh = show_mesh;
@@ -709,22 +605,17 @@ void renderImGui() {
     }
     // Add mesh
     if (ImGui::Button("Other mesh") && generatedMesh) {
-      if(skeletonFirstMesh.size()>0) {
-        for(auto m : skeletonFirstMesh)
-          renderer->removeRenderable(m);
-      }
       if(firstMesh) {
         renderer->removeRenderable(firstMesh);
       }
       if(generatedFirstMeshSkeleton) {
+        boneGizmos->removeSkeleton(generatedFirstMeshSkeleton);
         delete generatedFirstMeshSkeleton;
         generatedFirstMeshSkeleton = nullptr;
       }
       firstMesh = generatedMesh;
-      skeletonFirstMesh = skeletonMesh;
       generatedFirstMeshSkeleton = generatedMeshSkeleton;
       generatedMesh = nullptr;
-      skeletonMesh.clear();
       generatedMeshSkeleton = nullptr;
       firstMesh->getMaterial()->setDiffuseColor(cylinderMeshColorUnselected*0.01f);
       firstMesh->getMaterial()->setSpecularColor(cylinderMeshColorUnselected*0.001f);
@@ -765,10 +656,13 @@ void renderImGui() {
     if (ImGui::Button("Clear mesh")) {
       if(generatedMesh) {
         renderer->removeRenderable(generatedMesh);
+        delete generatedMesh;
+        generatedMesh = nullptr;
       }
-      if(skeletonMesh.size()>0) {
-        for(auto m : skeletonMesh)
-          renderer->removeRenderable(m);
+      if(generatedMeshSkeleton) {
+        boneGizmos->removeSkeleton(generatedMeshSkeleton);
+        delete generatedMeshSkeleton;
+        generatedMeshSkeleton = nullptr;
       }
     }
     ImGui::Separator();
@@ -777,11 +671,8 @@ void renderImGui() {
     ImGui::Text("Bones count = %d", bones_count);
     int prev_focus_bone_index = focus_bone_index;
     ImGui::SliderInt("Select bone", &focus_bone_index, 0, bones_count-1);
-    if(focus_bone_index != prev_focus_bone_index) {
-      for(unsigned i=0; i<bones_count; i++) {
-        ((Mesh*)skeletonMesh.at(i))->getMaterial()->setBasicColor(skeletonMeshColor);
-      }
-      ((Mesh*)skeletonMesh.at(focus_bone_index))->getMaterial()->setBasicColor(skeletonMeshColorHighLight);
+    if(focus_bone_index != prev_focus_bone_index && generatedMeshSkeleton) {
+      boneGizmos->setHighlightedBone(generatedMeshSkeleton, focus_bone_index, skeletonMeshColorHighLight);
       bone_rotation = glm::vec3(0.f);
     }
     // X axis
@@ -875,6 +766,9 @@ int main(int argc, char ** argv) {
 
   camController = new CameraController(renderer->getCamera());
   drawing = new Drawing();
+  boneGizmos = new BoneGizmos();
+  boneGizmos->setDepthTest(false);
+  renderer->addRenderable(boneGizmos);
 
   // renderer->addLight(Light::lightGetConstantCaster(
   //   lightPos1, lightColor*0.001f, lightColor, lightColor*0.f
@@ -906,6 +800,8 @@ int main(int argc, char ** argv) {
     delta = renderer->updateDeltaTime();
     renderer->render();
 
+    uploadPipelineResult();
+    updatePipeline();
     renderImGui();
     interactImGui();
     renderer->getCamera().setNear(cameraNear);
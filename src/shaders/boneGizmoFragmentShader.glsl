@@ -0,0 +1,9 @@
+#version 420 core
+
+in vec3 fcolor;
+
+out vec4 color;
+
+void main() {
+    color = vec4(fcolor, 1.0);
+}
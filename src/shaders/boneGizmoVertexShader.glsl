@@ -0,0 +1,20 @@
+#version 420 core
+
+layout(location=0) in vec3 vPosition;
+// Per bone : its transform (locations 1 to 4) and its color
+layout(location=1) in mat4 iTransform;
+layout(location=5) in vec4 iColor;
+
+out vec3 fcolor;
+
+// Camera, shared by every draw of the frame
+layout(std140, binding=1) uniform Camera {
+    mat4 viewMat;
+    mat4 projMat;
+    vec3 cameraPos;
+};
+
+void main() {
+    fcolor = iColor.rgb;
+    gl_Position = projMat * viewMat * iTransform * vec4(vPosition, 1.0);
+}
@@ -11,8 +11,12 @@ in FRAG {
     vec3 fcolor;
 } frag;
 
-// Camera
-uniform vec3 cameraPos;
+// Camera, shared by every draw of the frame
+layout(std140, binding=1) uniform Camera {
+    mat4 viewMat;
+    mat4 projMat;
+    vec3 cameraPos;
+};
 
 // Material
 uniform vec3 basicColor;
@@ -26,33 +30,33 @@ layout(binding=3) uniform sampler2D normalMap;
 
 // Lights
 struct Light {
+	// Each vec3 is followed by a float (see Light::UniformData)
 	vec3 lightPos;
-
-	// phong component colors
-	vec3 lightDiffuseColor;
-	vec3 lightSpecularColor;
-	vec3 lightAmbientColor;
-
-	// attenuation constants
 	float lightAtteConst;
+	vec3 lightDiffuseColor;
 	float lightAtteLin;
+	vec3 lightSpecularColor;
 	float lightAtteQuad;
+	vec3 lightAmbientColor;
+	float lightCamNear;
 
 	// Spot light
-	float lightCamNear;
-    float lightCamFar;
-    vec3 lightCamUp;
-    float lightFovAngleDegree;
-    vec3 lightLookAt;
+	vec3 lightCamUp;
+	float lightCamFar;
+	vec3 lightLookAt;
+	float lightFovAngleDegree;
+
+	mat4 shadowProjViewMat;
 
 	bool isSpotLight;
 	bool isShadowCaster;
-
-	sampler2D shadowMap;
-	mat4 shadowProjViewMat;
 };
-uniform Light lights[10];
-uniform uint lightCount;
+// Lights, shared by every draw of the frame
+layout(std140, binding=2) uniform Lights {
+	Light lights[10];
+	uint lightCount;
+};
+layout(binding=4) uniform sampler2D shadowMaps[10];
 
 vec3 computeColor(
 	in Light l, in vec3 fragDiffuseColor, in vec3 fragSpecularColor, in float fragShininess, in vec3 fragNormal
@@ -109,10 +113,10 @@ void main() {
 		// Pourcentage closer filtering :
 		// sample around the fragment.
 		float inShadowFactor = 1.0;
-		vec2 texelSize = 1.0 / textureSize(lights[i].shadowMap, 0); // Dimension of level 0 of the texture.
+		vec2 texelSize = 1.0 / textureSize(shadowMaps[i], 0); // Dimension of level 0 of the texture.
 		for(int xx=-1; xx<=1; ++xx) {
 			for(int yy=-1; yy<=1; ++yy) {
-				float pcfDepth = texture(lights[i].shadowMap, shadowMapTexCoord + vec2(xx, yy)*texelSize).x;
+				float pcfDepth = texture(shadowMaps[i], shadowMapTexCoord + vec2(xx, yy)*texelSize).x;
 				if(pcfDepth < fromLightSpaceFragPos.z-0.005) {
 					// Fragment in shadow
 					inShadowFactor -= 1.0/12.0;
@@ -4,6 +4,8 @@ layout(location=0) in vec3 vPosition;
 layout(location=1) in vec3 vNormal;
 layout(location=2) in vec3 vColor;
 layout(location=3) in vec2 vTexCoord;
+layout(location=4) in uvec4 vBoneIds;
+layout(location=5) in vec4 vBoneWeights;
 
 out FRAG {
     vec3 pos;
@@ -12,20 +14,20 @@ out FRAG {
     vec3 fcolor;
 } frag;
 
-uniform mat4 viewMat, projMat, worldMat;
+// Camera, shared by every draw of the frame
+layout(std140, binding=1) uniform Camera {
+    mat4 viewMat;
+    mat4 projMat;
+    vec3 cameraPos;
+};
+uniform mat4 worldMat;
 
 
-struct Bone {
-    vec3 A;
-    mat4 rotationMat;
-    uint parentIndexPlusOne;
+// Transform of each bone, its parents' ones included (see MeshSkeleton)
+layout(std140, binding=0) uniform BonesMatrices {
+    mat4 bonesMatrices[256];
 };
-
-uniform Bone bones[15];
 uniform uint bonesCount;
-uniform uint verticesCount;
-uniform uint textureElemSize;
-layout(binding=4) uniform sampler2D vertexTransformCoef;
 uniform bool hasBones;
 
 void main() {
@@ -35,38 +37,21 @@ void main() {
     vec4 normal = vec4(vNormal, 0.0);
     
     if(hasBones) {
-        int center = int(textureElemSize/2);
-        for(int b=0; b<bonesCount; b++) {
-            uint vert = gl_VertexID*textureElemSize+center;
-            uint bone = b*textureElemSize+center;
-            vec2 coefVec = vec2(
-                vert/float(verticesCount*textureElemSize),
-                bone/float(bonesCount*textureElemSize)
-            );
-            float coef = texture(vertexTransformCoef, coefVec).r;
-            if(coef == 1.0) {
-                pos = pos - vec4(bones[b].A, 0.0);
-                pos = bones[b].rotationMat * pos;
-                pos = pos + vec4(bones[b].A, 0.0);
-                
-                Bone parent = bones[b];
-                vec4 oldPos = pos;
-                while(
-                    parent.parentIndexPlusOne > 0 &&
-                    parent.parentIndexPlusOne <= bonesCount &&
-                    parent.parentIndexPlusOne-1!=b
-                ) {
-                    parent = bones[parent.parentIndexPlusOne-1];
-
-                    pos = pos - vec4(parent.A, 0.0);
-                    pos = parent.rotationMat * pos;
-                    pos = pos + vec4(parent.A, 0.0);
-                }
-                if(length(pos)==0) {
-                    pos = oldPos;
-                }
+        // Linear blend of the (up to) 4 bones of the vertex
+        vec4 skinned = vec4(0.0);
+        vec4 skinnedNormal = vec4(0.0);
+        float totalWeight = 0.0;
+        for(int i=0; i<4; i++) {
+            float weight = vBoneWeights[i];
+            if(weight > 0.0 && vBoneIds[i] < bonesCount) {
+                skinned += weight * (bonesMatrices[vBoneIds[i]] * pos);
+                skinnedNormal += weight * (bonesMatrices[vBoneIds[i]] * normal);
+                totalWeight += weight;
             }
-
+        }
+        if(totalWeight > 0.0) {
+            pos = skinned / totalWeight;
+            normal = skinnedNormal / totalWeight;
         }
     }
 
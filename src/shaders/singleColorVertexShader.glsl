@@ -2,7 +2,13 @@
 
 layout(location=0) in vec3 vPosition;
 
-uniform mat4 viewMat, projMat, worldMat;
+// Camera, shared by every draw of the frame
+layout(std140, binding=1) uniform Camera {
+    mat4 viewMat;
+    mat4 projMat;
+    vec3 cameraPos;
+};
+uniform mat4 worldMat;
 
 void main() {
     gl_Position = projMat * viewMat * worldMat * vec4(vPosition, 1.0);